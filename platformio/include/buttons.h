@@ -1,11 +1,11 @@
-
 #ifndef __SIMON_BUTTONS_H__
 #define __SIMON_BUTTONS_H__
 
 #include "config.h"
+#include "delegate.h"
+#include "settings.h"
 #include "types.h"
 #include <Arduino.h>
-#include <functional>
 
 namespace simon {
 
@@ -15,16 +15,24 @@ namespace simon {
 
 class Button {
   private:
-    const char* _name;
-    color_t _type;
-    int8_t _pin;
+    const char* _name = nullptr;
+    color_t _type     = color_t::ColorNone;
+    int8_t _pin       = -1;
+    uint8_t _bank     = 0;
     bool _is_pressed = false;
     bool _is_tapped  = false;
     bool _last_state = false;
+    bool _enabled    = true; // Cleared for a button held or stuck at boot
     unsigned long _last_debounce_time = 0;
+    uint32_t _last_edge_us            = 0; // micros() of the last raw pin transition
+    uint32_t _pressed_at_us           = 0; // micros() of the edge that started the press
+    uint32_t _released_at_us          = 0; // micros() of the edge that ended the press
 
   public:
-    Button(const char* name, color_t type, int8_t pin) : _name(name), _type(type), _pin(pin) {}
+    Button() = default;
+
+    Button(const char* name, color_t type, int8_t pin, uint8_t bank = 0) :
+        _name(name), _type(type), _pin(pin), _bank(bank) {}
 
     ~Button() {}
 
@@ -34,23 +42,54 @@ class Button {
 
     int8_t getPin() { return _pin; }
 
+    /**
+     * @brief Index of the button bank (player) this button belongs to.
+     */
+    uint8_t getBank() { return _bank; }
+
     bool isPressed() { return _is_pressed; }
 
     bool isTapped() { return _is_tapped; }
 
+    bool isEnabled() { return _enabled; }
+
+    void setEnabled(bool value) { _enabled = value; }
+
+    /**
+     * @brief Timestamp of the raw edge that started the current/last press.
+     * The value is captured with micros() when the pin first changes, so the
+     * debounce delay does not skew reaction time measurements.
+     */
+    uint32_t getPressedAt() { return _pressed_at_us; }
+
+    /**
+     * @brief Timestamp of the raw edge that ended the last press (micros()).
+     */
+    uint32_t getReleasedAt() { return _released_at_us; }
+
     void setTapped(bool value);
 
     void setPressed(bool value);
 
     bool readDigitalPin();
 
-    void updateState();
+    /**
+     * @brief Updates the debounced state from a pin reading.
+     * @param reading The pin reading (true = pressed).
+     * @param now_ms The sampling tick in milliseconds.
+     * @param now_us The sampling tick in microseconds.
+     * @param debounce_ms The time the reading must be stable to be accepted.
+     */
+    void updateState(bool reading, unsigned long now_ms, uint32_t now_us, uint16_t debounce_ms);
 
     void reset() {
         _is_pressed = false;
         _is_tapped  = false;
         _last_state = false;
         _last_debounce_time = 0;
+        _last_edge_us       = 0;
+        _pressed_at_us      = 0;
+        _released_at_us     = 0;
     }
 };
 
@@ -59,57 +98,82 @@ class Button {
 // -------------------------------------------
 
 class Buttons {
+  public:
+    typedef Delegate<void(Button& btn)> CallbackFunction;
+
   private:
-    Button _red_button;
-    Button _green_button;
-    Button _blue_button;
-    Button _yellow_button;
+    const config_t& _config;
+    Button _buttons[BUTTON_BANKS_COUNT][COLORS_COUNT];
     bool _paused            = false;
+    uint8_t _first_bank     = 0; // Bank processed first, rotated every tick for fairness
+    uint16_t _debounce_ms   = BUTTONS_DEBOUNCE_DELAY; // Cached from the config
+    uint8_t _injected[BUTTON_BANKS_COUNT]; // Buttons held down from the console, one bit each
 
-    Button* _pressed_button = nullptr;
-    Button* _tapped_button  = nullptr;
-
-    typedef std::function<void(Button& btn)> CallbackFunction;
+    Button* _pressed_button[BUTTON_BANKS_COUNT];
+    Button* _tapped_button[BUTTON_BANKS_COUNT];
 
     CallbackFunction pressed_cb  = nullptr;
     CallbackFunction released_cb = nullptr;
 
     void process_internal();
 
+    void process_bank(uint8_t bank);
+
   public:
-    Buttons() :
-        _red_button("red", color_t::ColorRed, RED_BUTTON_PIN),
-        _green_button("green", color_t::ColorGreen, GREEN_BUTTON_PIN),
-        _blue_button("blue", color_t::ColorBlue, BLUE_BUTTON_PIN),
-        _yellow_button("yellow", color_t::ColorYellow, YELLOW_BUTTON_PIN) {}
+    Buttons(const config_t& config);
 
     ~Buttons() {
         // Destructor
     }
 
+    /**
+     * @brief Configures the pins of the config.
+     */
     void setup();
 
+    /**
+     * @brief Applies the debounce delay of the config.
+     */
+    void configure();
+
+    /**
+     * @brief Disables the buttons that read as pressed at boot.
+     * They are ignored until they are seen released once.
+     * @return Bit (bank * COLORS_COUNT + index) set for every disabled button.
+     */
+    uint16_t selfTest();
+
     void loop();
 
-    bool isPressed();
+    bool isPressed(uint8_t bank = 0);
 
-    bool isTapped();
+    bool isTapped(uint8_t bank = 0);
 
     void setPressedCallback(CallbackFunction cb) { pressed_cb = cb; }
 
     void setReleasedCallback(CallbackFunction cb) { released_cb = cb; }
 
-    color_t getPressedButtonType() {
-        return _pressed_button ? _pressed_button->getType() : color_t::ColorNone;
+    color_t getPressedButtonType(uint8_t bank = 0) {
+        return _pressed_button[bank] ? _pressed_button[bank]->getType() : color_t::ColorNone;
     }
 
-    color_t getTappedButtonType() {
-        return _tapped_button ? _tapped_button->getType() : color_t::ColorNone;
+    color_t getTappedButtonType(uint8_t bank = 0) {
+        return _tapped_button[bank] ? _tapped_button[bank]->getType() : color_t::ColorNone;
     }
 
-    Button* getPressedButton() { return _pressed_button; }
+    Button* getPressedButton(uint8_t bank = 0) { return _pressed_button[bank]; }
+
+    Button* getTappedButton(uint8_t bank = 0) { return _tapped_button[bank]; }
+
+    Button& getButton(uint8_t bank, uint8_t index) { return _buttons[bank][index]; }
+
+    uint8_t getBanksCount() { return BUTTON_BANKS_COUNT; }
 
-    Button* getTappedButton() { return _tapped_button; }
+    /**
+     * @brief Simulates a button being held down (or released).
+     * The injected state goes through the same debouncing as the pin readings.
+     */
+    void inject(uint8_t bank, uint8_t index, bool pressed);
 
     void pause();
 
@@ -120,4 +184,4 @@ class Buttons {
 
 } // namespace simon
 
-#endif // __SIMON_BUTTONS_H__
\ No newline at end of file
+#endif // __SIMON_BUTTONS_H__
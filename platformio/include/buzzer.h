@@ -2,24 +2,24 @@
 #ifndef __SIMON_BUZZER_H__
 #define __SIMON_BUZZER_H__
 
+#include "settings.h"
+#include "synth.h"
 #include "types.h"
 #include <Arduino.h>
 
 namespace simon {
 class Buzzer {
   private:
-    int8_t _pin;
+    const config_t& _config;
+    Synth _synth; // PWM synth driving the buzzer pin
 
-    /**
-     * @brief Plays a tone on the buzzer.
-     * @param note The frequency of the note to play.
-     * @param duration The duration of the note in milliseconds.
-     * This function uses the Arduino tone() function to generate a sound on the buzzer.
-     */
-    void _tone(uint16_t note, uint16_t duration);
+    static constexpr uint8_t SUCCESS_STEPS_COUNT = 5;
+
+    uint16_t _success_ms = SUCCESS_TONE_DURATION; // Cached from the config
+    synth_step_t _success_steps[SUCCESS_STEPS_COUNT]; // Success sound with the current duration
 
   public:
-    Buzzer(int8_t pin) : _pin(pin) {}
+    Buzzer(const config_t& config) : _config(config) {}
 
     ~Buzzer() {
         // Destructor
@@ -27,10 +27,16 @@ class Buzzer {
 
     /**
      * @brief Initializes the buzzer.
-     * This function sets the pin mode for the buzzer to OUTPUT.
+     * This function attaches the configured pin to the PWM synth and starts its timer.
      * It should be called once in the setup phase of the program.
+     * @return false if the buzzer could not be started; every sound is then skipped.
      */
-    void setup();
+    bool setup();
+
+    /**
+     * @brief Applies the volume and tone settings of the config.
+     */
+    void configure();
 
     /**
      * @brief Starts playing a tone on the buzzer.
@@ -40,10 +46,28 @@ class Buzzer {
      */
     void toneStart(simon::note_t note, unsigned long duration = 0);
 
-    void singleTone(uint16_t note, uint16_t duration);
-
     void stop();
 
+    /**
+     * @brief Sets the output volume, 0 (mute) to 255 (full).
+     */
+    void setVolume(uint8_t volume) { _synth.setVolume(volume); }
+
+    uint8_t volume() const { return _synth.volume(); }
+
+    /**
+     * @brief Stops the synth timer while the game sleeps.
+     */
+    void suspend() { _synth.suspend(); }
+
+    void resume() { _synth.resume(); }
+
+    /**
+     * @brief Whether a sound of the given priority is still playing.
+     * All the play*() sounds below return immediately and play in the background.
+     */
+    bool isPlaying(sound_priority_t priority) const { return _synth.isPlaying(priority); }
+
     void playInitialSound();
 
     void playCountdownSound();
@@ -58,6 +82,11 @@ class Buzzer {
     void playRoundWinSound();
 
     void playNewHighScoreSound();
+
+    /**
+     * @brief Plays a melody of the library in the background.
+     */
+    void playMelody(melody_id_t id);
 };
 
 } // namespace simon
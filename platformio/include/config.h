@@ -4,6 +4,9 @@
 //
 // Simon Game Configuration
 //
+// Pin, timing and sound values are the defaults of the runtime Config (settings.h),
+// which can be overridden from NVS at boot.
+//
 
 // Pin Definitions
 // ------------------------------------------------------
@@ -24,6 +27,16 @@
 #define BLUE_BUTTON_PIN   D5
 #define YELLOW_BUTTON_PIN A7
 
+// Second button bank (versus mode), same color order
+#define RED_BUTTON_2_PIN    A0
+#define GREEN_BUTTON_2_PIN  A1
+#define BLUE_BUTTON_2_PIN   A2
+#define YELLOW_BUTTON_2_PIN A3
+
+#ifndef BUTTON_BANKS_COUNT
+#define BUTTON_BANKS_COUNT 2
+#endif
+
 #elif defined(XIAO_ESP32_C6)
 #define LED_PIN           D10
 #define LED_COUNT         24
@@ -37,8 +50,29 @@
 #define BLUE_BUTTON_PIN   D2
 #define YELLOW_BUTTON_PIN D3
 
+// No spare pins for a second button bank on the Xiao
+#ifndef BUTTON_BANKS_COUNT
+#define BUTTON_BANKS_COUNT 1
+#endif
+
 #endif // ARDUINO_NANO_ESP32
 
+// Button banks: one row of pins per player, in red, green, blue, yellow order
+#if BUTTON_BANKS_COUNT > 1
+#define BUTTON_BANKS_PINS                                                                          \
+    {                                                                                              \
+        {RED_BUTTON_PIN, GREEN_BUTTON_PIN, BLUE_BUTTON_PIN, YELLOW_BUTTON_PIN},                    \
+        {                                                                                          \
+            RED_BUTTON_2_PIN, GREEN_BUTTON_2_PIN, BLUE_BUTTON_2_PIN, YELLOW_BUTTON_2_PIN           \
+        }                                                                                          \
+    }
+#else
+#define BUTTON_BANKS_PINS                                                                          \
+    {                                                                                              \
+        { RED_BUTTON_PIN, GREEN_BUTTON_PIN, BLUE_BUTTON_PIN, YELLOW_BUTTON_PIN }                   \
+    }
+#endif
+
 // OLED Display Configuration
 // ------------------------------------------------------
 
@@ -47,6 +81,53 @@
 #define OLED_RESET     -1   // Reset pin # (or -1 if sharing Arduino reset pin)
 #define SCREEN_ADDRESS 0x3C ///< See datasheet for Address; 0x3D for 128x64, 0x3C for 128x32
 
+#define TEXT_CACHE_BYTES   4096 // Pool for pre-rendered text bitmaps
+#define TEXT_CACHE_SPRITES 32   // Maximum number of cached strings
+#define SCENE_MAX_WIDGETS  8    // Maximum number of widgets on a screen
+#define OLED_I2C_CHUNK     64   // Framebuffer bytes sent per I2C transaction
+#define OLED_I2C_CLOCK     400000UL // I2C clock used for the display
+#define OLED_SDA_PIN       SDA      // Display bus pins, bit-banged by the bus recovery
+#define OLED_SCL_PIN       SCL
+
+#define OLED_I2C_TIMEOUT_MS  10    // Wire timeout, bounds a transfer on a stuck bus
+#define OLED_I2C_RETRIES     2     // Retries of a failed transfer, each after a bus recovery
+#define OLED_I2C_BACKOFF_MS  2     // Delay before the first retry, doubled on every retry
+#define OLED_I2C_FAIL_LIMIT  3     // Consecutive failed flushes before the cooldown
+#define OLED_I2C_COOLDOWN_MS 10000 // Display transfers skipped after repeated failures
+
+#define FRAME_PIPELINE_FPS        30   // Target frame rate of the celebration animations
+#define FRAME_PIPELINE_STACK      3072 // Stack of the display transfer task
+#define PARTICLE_POOL_SIZE        96   // Maximum number of live particles
+#define CELEBRATION_LIGHTS_MS     4500 // Lights and rockets of the high score celebration
+#define CELEBRATION_FINALE_MS     1000 // Final burst on the display
+#define CELEBRATION_STEP_MS       150  // The celebration lights change every step
+#define PARTICLE_SHIFT            4    // Fractional bits of particle positions / velocities
+#define PARTICLE_GRAVITY          1    // Added to the spark vertical velocity every frame
+#define PARTICLE_ROCKET_SPEED     2    // Rocket climb, pixels per frame
+#define PARTICLE_BURST_SPARKS     16   // Sparks emitted by a bursting rocket
+#define PARTICLE_BURST_SPEED      28   // Spark speed, fixed point
+#define PARTICLE_BURST_LIFE       18   // Spark lifetime in frames
+
+// LEDs Configuration
+// ------------------------------------------------------
+#define LED_BRIGHTNESS 50 // NeoPixel brightness (0-255)
+#define LED_MAX_PIXELS 256 // Size of the layout index tables and of the layer buffers
+#define LED_FRAME_MS   20  // Shortest update period of the LED animations
+
+#define LED_RAINBOW_HUE_PER_S 87381 // Rainbow speed (65536 is one turn per second)
+#define LED_WIPE_PIXELS_PER_S 20    // Color wipe speed (pixels, or pixel pairs from the center)
+
+#define IDLE_RAINBOW_DURATION_MS 1400 // Length of the idle rainbow
+
+#define LED_LAYOUT_STRIP      0 // One strip, color segments one after the other
+#define LED_LAYOUT_RING       1 // Ring, color segments one after the other from LED_RING_OFFSET
+#define LED_LAYOUT_MATRIX     2 // Rows of LED_WIDTH pixels all wired in the same direction
+#define LED_LAYOUT_SERPENTINE 3 // Rows of LED_WIDTH pixels wired back and forth
+
+#define LED_LAYOUT      LED_LAYOUT_RING
+#define LED_WIDTH       LED_COUNT // Pixels per row (matrices, chained strips)
+#define LED_RING_OFFSET 0         // Physical pixel where the first (red) segment starts
+
 // Buttons Configuration
 // ------------------------------------------------------
 #define BUTTONS_TAP_DURATION   50
@@ -60,10 +141,98 @@
 #define BUZZER_DEBUG          1
 #define SUCCESS_TONE_DURATION 64   // Duration of success tone in milliseconds
 #define ERROR_TONE_DURATION   1500 // Duration of error tone in milliseconds
+#define SYNTH_TICK_MS         2    // Envelope / step resolution of the synth timer
+#define SYNTH_PWM_BITS        10   // LEDC duty resolution
+#define SYNTH_LEDC_CHANNEL    0    // LEDC channel (Arduino core 2.x only)
+#define SYNTH_DEFAULT_VOLUME  255  // 0 (mute) to 255
+#define MELODY_GATE_PERCENT   90   // Melody notes sound for this part of their length
+
+// Timers Configuration
+// ------------------------------------------------------
+#define TIMER_TICK_MS      10 // Timer wheel resolution
+#define TIMER_WHEEL_SLOTS  64 // Slots of the wheel (one revolution = 640 ms)
+#define TIMER_WHEEL_TIMERS 8  // Number of timer ids
+#define IDLE_PAGE_MS       5000  // Idle screen page duration
+#define IDLE_RAINBOW_MS    15000 // Idle rainbow interval
+
+// Power Configuration
+// ------------------------------------------------------
+#define POWER_DIM_MS         30000  // Idle time before dimming the display and the CPU
+#define POWER_SLEEP_MS       120000 // Idle time before light sleep
+#define POWER_IDLE_CPU_MHZ   80     // CPU frequency while dimmed (keeps APB at 80 MHz)
+#define POWER_IDLE_POLL_MS   5      // Main loop period while dimmed
+#define POWER_WAKE_TARGET_MS 50     // Wake-up to first frame latency target
+#define POWER_AWAKE_MA       70     // Estimated board current while awake
+#define POWER_DIMMED_MA      40     // Estimated board current while dimmed
+#define POWER_ASLEEP_MA      17     // Estimated current in light sleep (mostly the idle NeoPixels)
+
+// Boot Configuration
+// ------------------------------------------------------
+#define FAST_BOOT         1    // No setup delays, the splash plays while the game already runs
+#define BOOT_TARGET_MS    300  // Boot to first accepted input target
+#define SPLASH_RAINBOW_MS 1400 // Rainbow part of the splash
+#define SPLASH_WIPE_MS    300  // Duration of each color wipe of the splash
+#define SPLASH_HOLD_MS    1000 // Welcome message kept on screen after the wipes
+#define SPLASH_FRAME_MS   20   // LED update period of the splash
+
+// Console Configuration
+// ------------------------------------------------------
+#define CONSOLE_LINE_LENGTH  64 // Longest command line, including the terminator
+#define CONSOLE_MAX_ARGS     4  // Arguments of a command, including its name
+#define CONSOLE_MAX_COMMANDS 10
+#define CONSOLE_POLL_BYTES   32 // Input bytes consumed per loop at most
+
+// Supervisor Configuration
+// ------------------------------------------------------
+#define SUPERVISOR_WDT_MS         3000  // Loop watchdog, no iteration waits for more than a frame
+#define SUPERVISOR_LOOP_BUDGET_US 50000 // Loop iterations longer than this are counted as slow
+#define SUPERVISOR_MAX_DEPTH      4     // Nested scopes named in the stall record
+
+// Memory Configuration
+// ------------------------------------------------------
+#define MEMORY_ACCOUNTING 1 // Route operator new/delete through the per-module accounting
+#define MEMORY_STATES     8 // Per-state counters (at least the number of FSM states)
 
 // Game Configuration
 // ------------------------------------------------------
 #define MAX_SEQUENCE_LENGTH 100 // Maximum sequence length to prevent memory overflow
+#define MAX_PLAYERS         2   // Maximum number of players taking part in a game
+#define MODE_SELECT_HOLD_MS 1000 // Holding a button this long on the idle screen changes mode
+
+#if BUTTON_BANKS_COUNT > MAX_PLAYERS
+#error "Each button bank needs a player slot, increase MAX_PLAYERS"
+#endif
+
+// Reaction Time Configuration
+// ------------------------------------------------------
+#define REACTION_BUCKET_MS 20 // Resolution of the latency histogram in milliseconds
+#define REACTION_BUCKETS                                                                           \
+    (IN_SEQUENCE_TIMEOUT / REACTION_BUCKET_MS) // Histogram buckets (last one collects overflow)
+
+// Difficulty Configuration
+// ------------------------------------------------------
+#define DIFFICULTY_CURVE_LINEAR   0 // Durations shrink evenly every round
+#define DIFFICULTY_CURVE_EASE_OUT 1 // Durations shrink quickly at first, then level off
+#define DIFFICULTY_CURVE_STEPS    2 // Durations shrink every DIFFICULTY_STEP_ROUNDS rounds
+
+#define DIFFICULTY_CURVE            DIFFICULTY_CURVE_EASE_OUT
+#define DIFFICULTY_RAMP_ROUNDS      30  // Rounds needed to reach the minimum durations
+#define DIFFICULTY_STEP_ROUNDS      5   // Round interval used by DIFFICULTY_CURVE_STEPS
+#define SEQUENCE_STEP_ON_MAX        700 // Color display time at the first round (ms)
+#define SEQUENCE_STEP_ON_MIN        250 // Color display time at full speed (ms)
+#define SEQUENCE_STEP_OFF_MAX       100 // Pause between colors at the first round (ms)
+#define SEQUENCE_STEP_OFF_MIN       40  // Pause between colors at full speed (ms)
+#define SEQUENCE_TONE_PERCENT       70  // Tone length as a percentage of the display time
+#define DIFFICULTY_FAST_REACTION_MS 400 // Median reaction below this speeds playback up
+#define DIFFICULTY_SLOW_REACTION_MS 900 // Median reaction above this slows playback down
+#define DIFFICULTY_REACTION_SHIFT   64  // Progress shift (out of 256) applied by reaction time
+#define DIFFICULTY_MIN_SAMPLES      4   // Inputs required before reaction time is considered
+
+// Sequence Playback Configuration
+// ------------------------------------------------------
+#define SEQUENCE_LEAD_IN_MS 500 // Pause before the first color of the playback
+#define TIMELINE_MAX_ACTIONS                                                                       \
+    (MAX_SEQUENCE_LENGTH * 5 + 1) // Five actions per color plus the end marker
 
 // Debug Configuration
 // ------------------------------------------------------
@@ -0,0 +1,53 @@
+#ifndef __SIMON_CONSOLE_H__
+#define __SIMON_CONSOLE_H__
+
+#include "config.h"
+#include "delegate.h"
+#include <Arduino.h>
+
+namespace simon {
+
+/**
+ * @brief Serial command interpreter for live tuning and debugging.
+ * poll() consumes at most CONSOLE_POLL_BYTES of the receive FIFO per call and assembles the
+ * line in a fixed buffer, so it never waits for input nor allocates. Complete lines are
+ * split into whitespace separated arguments and dispatched to the registered commands.
+ * help lists them.
+ */
+class Console {
+  public:
+    typedef Delegate<void(uint8_t argc, char** argv)> CommandFunction;
+
+  private:
+    typedef struct Command {
+        const char* name;
+        const char* help;
+        CommandFunction run;
+    } command_t;
+
+    Stream& _stream;
+    char _line[CONSOLE_LINE_LENGTH];
+    uint8_t _length = 0;
+    bool _overflow  = false; // Line too long, dropped up to the next newline
+
+    command_t _commands[CONSOLE_MAX_COMMANDS];
+    uint8_t _commands_count = 0;
+
+    void execute();
+
+    void printHelp();
+
+  public:
+    Console(Stream& stream) : _stream(stream) {}
+
+    bool addCommand(const char* name, const char* help, CommandFunction run);
+
+    /**
+     * @brief Reads the pending input and runs the completed command, if any.
+     */
+    void poll();
+};
+
+} // namespace simon
+
+#endif // __SIMON_CONSOLE_H__
@@ -0,0 +1,59 @@
+#ifndef __SIMON_DELEGATE_H__
+#define __SIMON_DELEGATE_H__
+
+namespace simon {
+
+template <typename Signature> class Delegate;
+
+/**
+ * @brief Non-allocating callback: an object pointer plus a stub that calls the bound
+ * member function (or free function) on it.
+ * Two pointers in size, trivially copyable, and a dispatch is a single indirect call;
+ * unlike std::function it never allocates and has no type-erasure manager.
+ *
+ * Usage: Delegate<void(int)>::bind<Game, &Game::onValue>(this)
+ */
+template <typename R, typename... Args> class Delegate<R(Args...)> {
+  private:
+    typedef R (*stub_t)(void* object, Args... args);
+
+    void* _object = nullptr;
+    stub_t _stub  = nullptr;
+
+    Delegate(void* object, stub_t stub) : _object(object), _stub(stub) {}
+
+    template <class T, R (T::*Method)(Args...)> static R methodStub(void* object, Args... args) {
+        return (static_cast<T*>(object)->*Method)(args...);
+    }
+
+    template <R (*Function)(Args...)> static R functionStub(void*, Args... args) {
+        return Function(args...);
+    }
+
+  public:
+    Delegate() = default;
+
+    Delegate(decltype(nullptr)) {}
+
+    /**
+     * @brief Binds a member function of an object.
+     */
+    template <class T, R (T::*Method)(Args...)> static Delegate bind(T* object) {
+        return Delegate(object, &methodStub<T, Method>);
+    }
+
+    /**
+     * @brief Binds a free (or static member) function.
+     */
+    template <R (*Function)(Args...)> static Delegate bind() {
+        return Delegate(nullptr, &functionStub<Function>);
+    }
+
+    R operator()(Args... args) const { return _stub(_object, args...); }
+
+    explicit operator bool() const { return _stub != nullptr; }
+};
+
+} // namespace simon
+
+#endif // __SIMON_DELEGATE_H__
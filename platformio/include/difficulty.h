@@ -0,0 +1,53 @@
+#ifndef __SIMON_DIFFICULTY_H__
+#define __SIMON_DIFFICULTY_H__
+
+#include "config.h"
+#include "reaction.h"
+#include <Arduino.h>
+
+namespace simon {
+
+typedef struct StepTiming {
+    uint16_t on_ms;   // How long each color is shown
+    uint16_t off_ms;  // Pause between two colors
+    uint16_t tone_ms; // How long the color tone plays
+} step_timing_t;
+
+/**
+ * @brief Computes the sequence playback speed for each round.
+ * Progress towards full speed follows the DIFFICULTY_CURVE as rounds go by and is
+ * shifted by the player's measured median reaction time. All math is integer, with
+ * progress expressed out of 256.
+ */
+class Difficulty {
+  private:
+    step_timing_t _timing;
+    uint16_t _progress = 0; // 0 = slowest, 256 = fastest
+
+    static uint16_t curveProgress(uint16_t round);
+
+    static uint16_t interpolate(uint16_t from, uint16_t to, uint16_t progress);
+
+  public:
+    Difficulty() { reset(); }
+
+    /**
+     * @brief Restores the timing of the first round.
+     */
+    void reset();
+
+    /**
+     * @brief Recomputes the playback timing for the given round.
+     * @param round The 1-based round about to be played.
+     * @param stats The reaction latency measured so far in this game.
+     */
+    void update(uint16_t round, const LatencyStats& stats);
+
+    const step_timing_t& timing() const { return _timing; }
+
+    uint16_t progress() const { return _progress; }
+};
+
+} // namespace simon
+
+#endif // __SIMON_DIFFICULTY_H__
@@ -0,0 +1,77 @@
+#ifndef __SIMON_FRAMES_H__
+#define __SIMON_FRAMES_H__
+
+#include "config.h"
+#include "oled.h"
+#include <Arduino.h>
+
+namespace simon {
+
+/**
+ * @brief Double-buffered, fixed rate display updates.
+ * Frames are composed in the display framebuffer (the back buffer) and handed over with
+ * present(), which copies them into the front buffer and wakes a background task that
+ * transfers it over I2C. The next frame is composed while the previous one is still on the
+ * bus; present() only waits if that transfer has not finished yet.
+ */
+class FramePipeline {
+  private:
+    Oled& _oled;
+    uint8_t _front[SCREEN_WIDTH * SCREEN_HEIGHT / 8];
+
+    TaskHandle_t _task     = nullptr;
+    SemaphoreHandle_t _idle = nullptr; // Available when the front buffer is free
+
+    uint32_t _frame_us      = 0; // Frame period
+    uint32_t _deadline_us   = 0; // Start of the next frame slot
+    uint32_t _compose_start = 0;
+
+    // Statistics
+    uint16_t _frames             = 0;
+    uint16_t _missed             = 0; // Frames that overran their slot
+    uint32_t _compose_max_us     = 0;
+    uint32_t _compose_total_us   = 0;
+    uint32_t _stall_total_us     = 0; // Time present() waited for the bus
+    volatile uint32_t _transfer_max_us   = 0;
+    volatile uint32_t _transfer_total_us = 0;
+
+    static void transferTask(void* arg);
+
+  public:
+    FramePipeline(Oled& oled) : _oled(oled) {}
+
+    /**
+     * @brief Starts a new animation at the given frame rate.
+     * The transfer task is created on the first call.
+     * @return false if the task could not be created.
+     */
+    bool begin(uint8_t fps = FRAME_PIPELINE_FPS);
+
+    /**
+     * @brief Marks the start of the composition of a frame (for the statistics).
+     */
+    void compose() { _compose_start = micros(); }
+
+    /**
+     * @brief Queues the composed back buffer for transfer.
+     * @param back The framebuffer the frame was composed in.
+     */
+    void present(const uint8_t* back);
+
+    /**
+     * @brief Tells whether the next frame slot has started, for animations driven by the
+     * main loop. A frame that comes a whole slot late is counted as missed.
+     */
+    bool frameDue();
+
+    /**
+     * @brief Waits until the last frame has been transferred.
+     */
+    void finish();
+
+    void printStats() const;
+};
+
+} // namespace simon
+
+#endif // __SIMON_FRAMES_H__
@@ -1,9 +1,8 @@
 #ifndef __SIMON_FSM_H__
 #define __SIMON_FSM_H__
 
+#include "delegate.h"
 #include <Arduino.h>
-#include <functional>
-#include <tinyfsm.hpp>
 
 namespace simon {
 namespace Fsm {
@@ -15,6 +14,7 @@ typedef enum EventType {
     PLAYING_USER_EVENT,
     PLAYING_WIN_EVENT,
     PLAYING_LOSE_EVENT,
+    EVENT_TYPES_COUNT,
 } EventType;
 
 typedef enum StateType {
@@ -24,89 +24,165 @@ typedef enum StateType {
     PLAYING_USER_STATE,
     PLAYING_WIN_STATE,
     PLAYING_LOSE_STATE,
+    STATE_TYPES_COUNT,
 } StateType;
 
-String stateTypeToString(StateType type);
-
-String eventTypeToString(EventType type);
-
-struct Event : public ::tinyfsm::Event {
-    EventType type;
-    Event(EventType t) : type(t) {}
-};
-
-struct GameStart : Event {
-    GameStart() : Event(EventType::GAME_START_EVENT) {}
+const __FlashStringHelper* stateTypeToString(StateType type);
+
+const __FlashStringHelper* eventTypeToString(EventType type);
+
+typedef struct Transition {
+    StateType from;
+    EventType event;
+    StateType to;
+} transition_t;
+
+// Every legal transition of the game
+inline constexpr transition_t TRANSITIONS[] = {
+    {INITIAL_STATE, GAME_START_EVENT, GAME_START_STATE},
+    {INITIAL_STATE, PLAYING_SEQUENCE_EVENT, PLAYING_SEQUENCE_STATE}, // Resumed after a reset
+    {GAME_START_STATE, PLAYING_SEQUENCE_EVENT, PLAYING_SEQUENCE_STATE},
+    {PLAYING_SEQUENCE_STATE, PLAYING_USER_EVENT, PLAYING_USER_STATE},
+    {PLAYING_SEQUENCE_STATE, INITIAL_STATE_EVENT, INITIAL_STATE}, // Longest sequence completed
+    {PLAYING_USER_STATE, PLAYING_WIN_EVENT, PLAYING_WIN_STATE},
+    {PLAYING_USER_STATE, PLAYING_LOSE_EVENT, PLAYING_LOSE_STATE},
+    {PLAYING_WIN_STATE, PLAYING_SEQUENCE_EVENT, PLAYING_SEQUENCE_STATE},
+    {PLAYING_LOSE_STATE, INITIAL_STATE_EVENT, INITIAL_STATE},
 };
 
-typedef std::function<void(StateType const&)> CallbackEnterFunction;
-typedef std::function<void(StateType const&)> CallbackExitFunction;
-
-struct Switch : public ::tinyfsm::Fsm<Switch> {
-
-  protected:
-    StateType type;
-
-  public:
-    Switch()  = default;
-    ~Switch() = default;
-
-    // State machine methods
-    virtual void react(Event const& event);
-    virtual void entry();
-    virtual void exit();
-
-    StateType getType() const { return type; }
-
-    // Static methods for state management
-    static void reset();
-    static void init();
-
-    static Switch& currentState();
-};
+#define NO_TRANSITION 0xFF
+
+typedef struct TransitionTable {
+    uint8_t next[STATE_TYPES_COUNT][EVENT_TYPES_COUNT]; // Next state, or NO_TRANSITION
+    bool unique;                                        // No (state, event) pair listed twice
+} transition_table_t;
+
+constexpr transition_table_t buildTransitionTable() {
+    transition_table_t table = {};
+    table.unique             = true;
+
+    for (uint8_t s = 0; s < STATE_TYPES_COUNT; s++) {
+        for (uint8_t e = 0; e < EVENT_TYPES_COUNT; e++) {
+            table.next[s][e] = NO_TRANSITION;
+        }
+    }
+
+    for (const transition_t& t : TRANSITIONS) {
+        if (table.next[t.from][t.event] != NO_TRANSITION) {
+            table.unique = false;
+        }
+        table.next[t.from][t.event] = t.to;
+    }
+    return table;
+}
+
+// State x event lookup, built at compile time
+inline constexpr transition_table_t TRANSITION_TABLE = buildTransitionTable();
+
+/**
+ * @brief Whether every state can be reached from the initial state.
+ */
+constexpr bool allStatesReachable() {
+    bool reached[STATE_TYPES_COUNT] = {};
+    reached[INITIAL_STATE]          = true;
+
+    // Relax until nothing changes (at most one new state per pass)
+    for (uint8_t pass = 0; pass < STATE_TYPES_COUNT; pass++) {
+        for (const transition_t& t : TRANSITIONS) {
+            if (reached[t.from]) {
+                reached[t.to] = true;
+            }
+        }
+    }
+
+    for (bool state : reached) {
+        if (!state) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Whether every state handles at least one event (no dead ends).
+ */
+constexpr bool allStatesHandled() {
+    for (uint8_t s = 0; s < STATE_TYPES_COUNT; s++) {
+        bool handled = false;
+        for (uint8_t e = 0; e < EVENT_TYPES_COUNT; e++) {
+            handled = handled || TRANSITION_TABLE.next[s][e] != NO_TRANSITION;
+        }
+        if (!handled) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Whether every event triggers at least one transition.
+ */
+constexpr bool allEventsUsed() {
+    for (uint8_t e = 0; e < EVENT_TYPES_COUNT; e++) {
+        bool used = false;
+        for (uint8_t s = 0; s < STATE_TYPES_COUNT; s++) {
+            used = used || TRANSITION_TABLE.next[s][e] != NO_TRANSITION;
+        }
+        if (!used) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static_assert(TRANSITION_TABLE.unique, "A (state, event) pair has more than one transition");
+static_assert(allStatesReachable(), "A state cannot be reached from INITIAL_STATE");
+static_assert(allStatesHandled(), "A state has no outgoing transition");
+static_assert(allEventsUsed(), "An event is never handled");
+
+typedef Delegate<void(StateType const&)> CallbackEnterFunction;
+typedef Delegate<void(StateType const&)> CallbackExitFunction;
 
 void setEnterCallback(CallbackEnterFunction cb);
 void setExitCallback(CallbackExitFunction cb);
-void dispatchStateEnter(Switch& state);
-void dispatchStateExit(Switch& state);
 
-struct InitialState : public Switch {
-    InitialState() { type = StateType::INITIAL_STATE; }
-    virtual ~InitialState() = default;
-    void react(Event const& event) override;
-};
-
-struct GameStartState : public Switch {
-    GameStartState() { type = StateType::GAME_START_STATE; }
-    virtual ~GameStartState() = default;
-    void react(Event const& event) override;
-};
-
-struct PlayingSequenceState : public Switch {
-    PlayingSequenceState() { type = StateType::PLAYING_SEQUENCE_STATE; }
-    virtual ~PlayingSequenceState() = default;
-    void react(Event const& event) override;
-};
-
-struct PlayingUserState : public Switch {
-    PlayingUserState() { type = StateType::PLAYING_USER_STATE; }
-    virtual ~PlayingUserState() = default;
-    void react(Event const& event) override;
-};
-
-struct PlayingWinState : public Switch {
-    PlayingWinState() { type = StateType::PLAYING_WIN_STATE; }
-    virtual ~PlayingWinState() = default;
-    void react(Event const& event) override;
-};
-
-struct PlayingLoseState : public Switch {
-    PlayingLoseState() { type = StateType::PLAYING_LOSE_STATE; }
-    virtual ~PlayingLoseState() = default;
-    void react(Event const& event) override;
-};
+/**
+ * @brief Moves back to the initial state without calling the callbacks.
+ */
+void reset();
+
+/**
+ * @brief Enters the current state (calls the enter callback).
+ */
+void start();
+
+StateType currentState();
+
+/**
+ * @brief Looks the event up in the transition table of the current state.
+ * Callbacks may dispatch again from inside the enter callback.
+ * @return false if the current state does not handle the event.
+ */
+bool dispatch(EventType event);
+
+/**
+ * @brief Dispatches an event from a known state.
+ * The transition is checked against the table at compile time; at runtime the call is
+ * ignored if the machine is not in the expected state.
+ */
+template <StateType From, EventType Event> bool dispatchFrom() {
+    static_assert(TRANSITION_TABLE.next[From][Event] != NO_TRANSITION,
+                  "Illegal transition: the state does not handle this event");
+
+    if (currentState() != From) {
+        Serial.print(F("Error: dispatch expected state "));
+        Serial.println(stateTypeToString(From));
+        return false;
+    }
+    return dispatch(Event);
+}
 
 } // namespace Fsm
 } // namespace simon
 
-#endif // __SIMON_FSM_H__
\ No newline at end of file
+#endif // __SIMON_FSM_H__
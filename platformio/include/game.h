@@ -4,24 +4,116 @@
 #include "board.h"
 #include "buttons.h"
 #include "buzzer.h"
+#include "console.h"
+#include "difficulty.h"
+#include "frames.h"
 #include "fsm.h"
+#include "health.h"
 #include "leds.h"
+#include "memory.h"
+#include "modes.h"
+#include "oled.h"
+#include "particles.h"
+#include "power.h"
+#include "reaction.h"
+#include "scene.h"
+#include "settings.h"
+#include "snapshot.h"
+#include "supervisor.h"
+#include "sprites.h"
+#include "timeline.h"
+#include "timers.h"
 #include <Adafruit_NeoPixel.h>
 #include <Adafruit_SSD1306.h>
 #include <Arduino.h>
 
 namespace simon {
 
+typedef enum TimerId {
+    TimerInputTimeout, // One per player: no input for input_timeout_ms
+    TimerIdlePage = TimerInputTimeout + MAX_PLAYERS, // Switch the idle screen page
+    TimerIdleRainbow,                                // Idle rainbow
+    TimerPowerDim,                                   // Inactivity before dimming
+    TimerPowerSleep,                                 // Inactivity before light sleep
+    TimerStep,                                       // Next step of the running sequence
+    TIMER_IDS_COUNT,
+} timer_id_t;
+
+static_assert(TIMER_IDS_COUNT <= TIMER_WHEEL_TIMERS, "TIMER_WHEEL_TIMERS is too small");
+
+#define STEPS_DONE 0xFFFFFFFF // Returned by the last step of a sequence
+
 class Game {
   private:
+    // One step of a timed sequence (countdown, round end...): runs step number step and
+    // returns the delay before the next one, or STEPS_DONE
+    typedef Delegate<uint32_t(uint8_t step)> StepFunction;
+
+    config_t _config;          // Runtime configuration, read by the subsystems below
     Leds _leds;                // Reference to the LED controller
     Buttons _buttons;          // Reference to the button controller
     Buzzer _buzzer;            // Reference to the buzzer controller
     Adafruit_SSD1306 _display; // Reference to the OLED display controller
+    Oled _oled;                // Partial framebuffer transfers for _display
     Board _board;              // Reference to the board controller
+    Health _health;            // Boot self-test results
+    TextCache _text;           // Pre-rendered strings for the display
+    Scene _scene;              // Widgets of the current screen
+    int8_t _idle_layout  = -1; // Idle page currently shown
+    int8_t _color_widget = -1; // Color name widget during the playback
+    FramePipeline _frames;     // Double-buffered animation updates
+    ParticleSystem _particles; // Fireworks and sparkles of the celebration
 
     uint32_t _high_score = 0; // High score
 
+    ReactionTimer _reaction[MAX_PLAYERS]; // Input timestamps of the current round
+    LatencyStats _latency[MAX_PLAYERS];   // Reaction latency of each player in this game
+    Difficulty _difficulty;               // Sequence playback speed controller
+    unsigned long _game_start_time = 0;   // millis() when the current game started
+
+    Timeline _timeline;                   // Compiled playback of the current round
+    TimelinePlayer _playback;             // Non-blocking player for _timeline
+
+    uint8_t _mode_index   = 0;            // Index of the selected game mode
+    GameMode* _mode       = nullptr;      // Rules of the current game
+    uint8_t _input_length = 0;            // Inputs expected in the current round
+
+    TimerWheel _timers;                   // Timeouts, cancelled when their state exits
+
+    Power _power;                         // Idle dimming and light sleep
+    bool _sleep_requested = false;        // Enter light sleep from the next idle loop
+    bool _waking          = false;        // The press that woke the game up is not an input
+
+    bool _splash              = false;    // Boot splash still playing
+    uint32_t _splash_start_ms = 0;
+    int32_t _splash_frame     = -1;       // Last splash frame shown
+
+    bool _rainbow              = false;   // Rainbow playing on the background layer
+    uint32_t _rainbow_start_ms = 0;
+    uint16_t _rainbow_ms       = 0;       // Length of the rainbow
+    int32_t _rainbow_frame     = -1;
+
+    StepFunction _steps;                  // Sequence run by TimerStep in the current state
+    uint8_t _step = 0;                    // Next step of _steps
+
+    bool _celebrating              = false; // High score celebration playing from the loop
+    uint32_t _celebration_start_ms = 0;
+    int16_t _celebration_step      = -1;    // Last step of the lights
+    uint16_t _celebration_frame    = 0;     // Display frames composed so far
+    bool _celebration_finale       = false;
+
+    uint8_t _best_score = 0;              // Best final score of the game that just ended
+
+    Console _console;                     // Serial commands for live tuning
+
+    bool _resuming = false;               // The round was restored from the snapshot
+
+    void selectMode(uint8_t index);
+
+    uint8_t playerForButton(Button& btn);
+
+    void finishPlayer(uint8_t player, bool passed);
+
     void onStateEnter(Fsm::StateType const& type);
 
     void onStateLoop(Fsm::StateType const& type);
@@ -34,26 +126,90 @@ class Game {
 
     void displayWelcomeMessage();
 
+    void bootProgress(const __FlashStringHelper* message, uint16_t pause_ms = 0);
+
+    bool splashFrame(uint32_t now_ms);
+
+    void endSplash();
+
+    void cacheTexts();
+
     void onEnterInitialState();
 
     void onEnterGameStartState();
 
+    uint32_t gameStartStep(uint8_t step);
+
     void onEnterPlayingSequenceState();
 
+    uint32_t totalVictoryStep(uint8_t step);
+
+    void saveSnapshot();
+
+    void resumeGame(const game_snapshot_t& snapshot, const Sequence& saved);
+
     void onEnterPlayingUserState();
 
     void onEnterPlayingWinState();
 
+    uint32_t winStep(uint8_t step);
+
     void onEnterPlayingLoseState();
 
+    uint32_t loseStep(uint8_t step);
+
+    void displayResult();
+
+    void startSteps(StepFunction steps);
+
+    void runStep();
+
     void onLoopInitialState();
 
-    void onLoopPlayingUserState();
+    void showIdlePage(uint8_t page);
+
+    void restartIdle();
+
+    void startRainbow(uint16_t duration_ms);
+
+    void rainbowFrame(uint32_t now_ms);
 
-    void synchronizedCelebration();
-    void drawFireworks(int step);
-    void drawSingleFirework(int centerX, int centerY, int stage);
-    void drawFinalFireworks();
+    void onTimerExpired(uint8_t id);
+
+    void armPowerTimers();
+
+    void enterSleep();
+
+    void wakeUp();
+
+    void onLoopPlayingSequenceState();
+
+    void runTimelineAction(const timeline_action_t& action);
+
+    bool displayReactionStats(uint8_t player);
+
+    void saveReactionStats(uint8_t player);
+
+    void printThroughput();
+    void registerMemory(); // Static size of the subsystems for the memory report
+
+    void registerConsole();
+    void applyConfig(); // Pushes a changed config to the subsystems
+    void onGetCommand(uint8_t argc, char** argv);
+    void onSetCommand(uint8_t argc, char** argv);
+    void onSaveCommand(uint8_t argc, char** argv);
+    void onStatsCommand(uint8_t argc, char** argv);
+    void onStateCommand(uint8_t argc, char** argv);
+    void onCelebrateCommand(uint8_t argc, char** argv);
+    void onButtonCommand(uint8_t argc, char** argv);
+
+    void startCelebration();
+    void celebrationFrame(uint32_t now_ms);
+    void stopCelebration();
+    void celebrationLights(int step);
+    void drawCelebrationFrame(bool finale);
+    uint32_t celebrationTestStep(uint8_t step);
+    uint32_t resetHighScoreStep(uint8_t step);
 
   public:
     Game();
@@ -65,6 +221,8 @@ class Game {
     void testCelebrationEffects();    // Test celebration effects (for debugging)
     void resetHighScore();            // Reset high score with visual notification
     Fsm::StateType getCurrentState(); // Get current FSM state
+
+    const config_t& config() { return _config; }
 };
 
 } // namespace simon
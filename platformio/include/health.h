@@ -0,0 +1,49 @@
+#ifndef __SIMON_HEALTH_H__
+#define __SIMON_HEALTH_H__
+
+#include "config.h"
+#include <Arduino.h>
+#include <Wire.h>
+
+namespace simon {
+
+typedef enum Capability {
+    CapDisplay = 1 << 0, // SSD1306 answers on the I2C bus
+    CapLeds    = 1 << 1, // NeoPixel buffer allocated, layout fits the strip
+    CapBuzzer  = 1 << 2, // LEDC output and synth timer running
+    CapButtons = 1 << 3, // No button stuck at boot
+    CapStorage = 1 << 4, // Preferences (NVS) available
+    CAPABILITIES_ALL = 0x1F,
+} capability_t;
+
+/**
+ * @brief Results of the boot self-test.
+ * Every subsystem is probed once in Game::setup() and the result is kept as a capability
+ * mask. Output is only routed to the devices that passed, so a missing peripheral costs a
+ * flag test instead of bus timeouts in the main loop.
+ */
+class Health {
+  private:
+    uint8_t _caps           = 0;
+    uint16_t _stuck_buttons = 0; // Bit (bank * COLORS_COUNT + index) for each stuck button
+
+  public:
+    /**
+     * @brief Checks whether a device acknowledges its I2C address.
+     */
+    static bool probeI2C(TwoWire& wire, uint8_t address);
+
+    void set(capability_t cap, bool ok);
+
+    bool has(capability_t cap) const { return (_caps & cap) != 0; }
+
+    uint8_t mask() const { return _caps; }
+
+    void setStuckButtons(uint16_t mask);
+
+    void printReport() const;
+};
+
+} // namespace simon
+
+#endif // __SIMON_HEALTH_H__
@@ -0,0 +1,58 @@
+#ifndef __SIMON_LAYOUT_H__
+#define __SIMON_LAYOUT_H__
+
+#include "settings.h"
+#include "types.h"
+#include <Arduino.h>
+
+namespace simon {
+
+/**
+ * @brief Maps the logical LED space onto the physical pixels of the strip.
+ * The index tables are built once from the config, so effects written in logical space
+ * (a color segment, a row / column position) only cost a table lookup per pixel.
+ *
+ * Strips and rings have one row: each color owns a quarter of it. Matrices (and chained
+ * strips of LED_WIDTH pixels) have one quadrant per color.
+ */
+class LedLayout {
+  private:
+    uint8_t _xy[LED_MAX_PIXELS];    // Physical pixel of each logical (x, y), row after row
+    uint8_t _order[LED_MAX_PIXELS]; // Physical pixels grouped by segment, in logical order
+    uint16_t _segment_start[COLORS_COUNT + 1];
+    uint16_t _width  = 0;
+    uint16_t _height = 0;
+
+    void buildSegments();
+
+  public:
+    /**
+     * @brief Builds the index tables.
+     * @return false if the layout does not fit led_count (a plain strip is used instead).
+     */
+    bool build(const config_t& config);
+
+    uint16_t width() const { return _width; }
+
+    uint16_t height() const { return _height; }
+
+    /**
+     * @brief Segment of a color: red, green, blue and yellow in wiring order.
+     */
+    static uint8_t segmentOf(color_t color) { return COLORS_COUNT - 1 - color; }
+
+    uint16_t segmentSize(uint8_t segment) const {
+        return _segment_start[segment + 1] - _segment_start[segment];
+    }
+
+    /**
+     * @brief Physical pixels of a segment, from its logical start to its end.
+     */
+    const uint8_t* segment(uint8_t segment) const { return _order + _segment_start[segment]; }
+
+    uint8_t pixelAt(uint16_t x, uint16_t y) const { return _xy[y * _width + x]; }
+};
+
+} // namespace simon
+
+#endif // __SIMON_LAYOUT_H__
@@ -1,6 +1,8 @@
 #ifndef __SIMON_LEDS_H__
 #define __SIMON_LEDS_H__
 
+#include "layout.h"
+#include "settings.h"
 #include "types.h"
 #include <Adafruit_NeoPixel.h>
 #include <Arduino.h>
@@ -8,49 +10,170 @@
 namespace simon {
 
 typedef enum WipeDirection {
-    WipeFromStart,  // Wipe from the start of the strip
-    WipeFromCenter, // Wipe from the center of the strip
-    WipeFromEdges,  // Wipe from the edges of the strip
+    WipeFromStart,  // Wipe from the start of the segment
+    WipeFromCenter, // Wipe from the center of the segment
+    WipeFromEdges,  // Wipe from the edges of the segment
 } wipe_direction_t;
 
+typedef enum LedLayerId {
+    LayerBackground, // Idle and celebration animations, always opaque
+    LayerFeedback,   // Colors of the pressed buttons and of the sequence playback
+    LayerAlert,      // Flashes drawn over everything else
+    LED_LAYERS_COUNT,
+} led_layer_t;
+
+typedef enum LedBlend {
+    BlendAlpha, // Covers the layers below by the pixel alpha
+    BlendAdd,   // Adds to the layers below (saturating)
+} led_blend_t;
+
+typedef struct LedLayer {
+    uint8_t rgb[LED_MAX_PIXELS * 3]; // Packed colors
+    uint8_t alpha[LED_MAX_PIXELS];   // Coverage of each pixel, 0 where nothing was drawn
+    uint8_t opacity;                 // Applied on top of the pixel alpha
+    uint8_t blend;                   // led_blend_t
+    bool empty;                      // Nothing drawn since the last clear (skipped)
+} led_layer_buffer_t;
+
+/**
+ * @brief NeoPixel effects drawn into compositing layers.
+ * Drawing only changes a layer; show() blends the layers into one packed RGB frame and
+ * sends it to the strip, and does nothing if no layer changed. The game calls it once per
+ * loop, the blocking effects after every step. The blocking effects are only meant for the
+ * boot sequence, before the loop watchdog starts.
+ */
 class Leds {
   private:
     Adafruit_NeoPixel& _strip;
+    const config_t& _config;
+    LedLayout _layout;
 
-    void
-    wipeFromCenter(uint32_t color, unsigned long wait, unsigned int firstPixel, unsigned int count);
+    led_layer_buffer_t _layers[LED_LAYERS_COUNT];
+    uint8_t _frame[LED_MAX_PIXELS * 3]; // Composed frame
+    bool _dirty   = true;               // A layer changed since the last show()
+    bool _present = true;               // Cleared when the LEDs failed the self-test
 
-    void
-    wipeFromEdged(uint32_t color, unsigned long wait, unsigned int firstPixel, unsigned int count);
+    void setPixel(led_layer_t layer, uint16_t pixel, uint32_t color, uint8_t alpha = 255);
 
-    void
-    wipeFromStart(uint32_t color, unsigned long wait, unsigned int firstPixel, unsigned int count);
+    void compose();
 
-  public:
-    Leds(Adafruit_NeoPixel& strip) : _strip(strip) {}
-
-    void setup();
-
-    void showColor(simon::color_t c, unsigned long wait = 0);
-
-    void fill(uint32_t color, unsigned int firstPixel = 0, unsigned int count = 0);
-
-    void fill_all(color_t color) { fill(colorToRGB(color), 0, _strip.numPixels()); }
+    /**
+     * @brief Sleeps until the next LED_FRAME_MS boundary of an effect started at start_ms.
+     */
+    void waitFrame(uint32_t start_ms);
 
+  public:
+    Leds(Adafruit_NeoPixel& strip, const config_t& config);
+
+    /**
+     * @brief Applies the pin, length and layout of the config and turns every pixel off.
+     * @return false if the layout does not fit the strip; the pixels are then driven as a
+     * plain strip.
+     */
+    bool setup();
+
+    /**
+     * @brief Applies the brightness of the config.
+     */
+    void configure();
+
+    const LedLayout& layout() const { return _layout; }
+
+    /**
+     * @brief Routes (or stops routing) the frames to the strip.
+     * When the LEDs are absent every show() returns immediately.
+     */
+    void setPresent(bool present) { _present = present; }
+
+    /**
+     * @brief Changes how a layer is blended over the ones below it.
+     */
+    void setBlend(led_layer_t layer, led_blend_t blend, uint8_t opacity = 255);
+
+    /**
+     * @brief Lights the segment of a color, wiped from its center at LED_WIPE_PIXELS_PER_S
+     * (blocking) if animate is set.
+     */
+    void showColor(simon::color_t c, bool animate = false, led_layer_t layer = LayerFeedback);
+
+    /**
+     * @brief Clears the segment of a color, leaving the rest of the layer alone.
+     */
+    void hideColor(simon::color_t c, led_layer_t layer = LayerFeedback);
+
+    void fill(uint32_t color,
+              unsigned int firstPixel = 0,
+              unsigned int count      = 0,
+              led_layer_t layer       = LayerAlert);
+
+    void fill_all(color_t color, led_layer_t layer = LayerAlert) {
+        fill(colorToRGB(color), 0, _strip.numPixels(), layer);
+    }
+
+    /**
+     * @brief Sets the first pixels of a segment (in logical order).
+     * @param count Pixels to set, 0 for the whole segment.
+     */
+    void setSegment(uint8_t segment,
+                    uint32_t color,
+                    uint16_t count    = 0,
+                    led_layer_t layer = LayerBackground);
+
+    /**
+     * @brief Clears every layer and shows the result right away.
+     */
     void clearNow();
 
+    /**
+     * @brief Clears every layer.
+     */
     void clear();
 
-    void show();
+    void clear(led_layer_t layer);
 
-    // Rainbow cycle along whole strip. Pass delay time (in ms) between frames.
-    void rainbow(unsigned long wait = 2, uint8_t count = 2);
+    /**
+     * @brief Sends the composed layers to the strip, if anything changed.
+     */
+    void show();
 
+    /**
+     * @brief Hue of the first pixel after elapsed_ms of a rainbow turning at hue_per_s
+     * (65536 is one turn of the color wheel per second).
+     */
+    static uint16_t rainbowHue(uint32_t elapsed_ms, uint32_t hue_per_s = LED_RAINBOW_HUE_PER_S);
+
+    /**
+     * @brief Plays the rainbow cycle on the background for duration_ms (blocking).
+     * The speed only depends on the clock, frames are shown every LED_FRAME_MS at most.
+     */
+    void rainbow(uint16_t duration_ms);
+
+    // Single background frame of the rainbow cycle, for callers that animate it themselves.
+    void rainbowFrame(uint16_t firstPixelHue);
+
+    /**
+     * @brief Number of steps of a wipe over count pixels (pixels lit together are one step).
+     */
+    static uint16_t wipeSteps(simon::wipe_direction_t direction, uint16_t count);
+
+    /**
+     * @brief Draws a wipe over a segment of the layout (see LedLayout::segmentOf).
+     * @param position Wipe progress in steps, 8.8 fixed point: the pixels of the step being
+     * reached get the fractional part as alpha, so slow wipes still move smoothly.
+     */
+    void wipeFrame(uint32_t color,
+                   simon::wipe_direction_t direction,
+                   uint8_t segment,
+                   uint32_t position,
+                   led_layer_t layer = LayerBackground);
+
+    /**
+     * @brief Wipes a color over a segment at LED_WIPE_PIXELS_PER_S (blocking).
+     */
     void wipe(uint32_t color,
-              simon::wipe_direction_t direction = simon::WipeFromStart,
-              unsigned long wait                = 0,
-              unsigned int firstPixel           = 0,
-              unsigned int count                = 0);
+              simon::wipe_direction_t direction,
+              uint8_t segment,
+              led_layer_t layer = LayerBackground);
 };
 } // namespace simon
 
@@ -0,0 +1,26 @@
+#ifndef __SIMON_MELODIES_FRA_MARTINO_H__
+#define __SIMON_MELODIES_FRA_MARTINO_H__
+
+#include "melody.h"
+
+namespace simon {
+namespace melodies {
+
+// Fra Martino, traditional
+inline constexpr int16_t FRA_MARTINO_SCORE[] = {
+    NOTE_C5, 4, NOTE_D5, 4, NOTE_E5, 4, NOTE_C5, 4, NOTE_C5, 4, NOTE_D5, 4, NOTE_E5, 4, NOTE_C5, 4,
+    NOTE_E5, 4, NOTE_F5, 4, NOTE_G5, 2, NOTE_E5, 4, NOTE_F5, 4, NOTE_G5, 2,
+
+    NOTE_G5, 8, NOTE_A5, 8, NOTE_G5, 8, NOTE_F5, 8, NOTE_E5, 4, NOTE_C5, 4,
+    NOTE_G5, 8, NOTE_A5, 8, NOTE_G5, 8, NOTE_F5, 8, NOTE_E5, 4, NOTE_C5, 4,
+    NOTE_C5, 4, NOTE_G4, 4, NOTE_C5, 2, NOTE_C5, 4, NOTE_G4, 4, NOTE_C5, 2};
+
+inline constexpr auto FRA_MARTINO_DATA = compileMelody(FRA_MARTINO_SCORE);
+static_assert(FRA_MARTINO_DATA.valid, "Fra Martino: unknown note or note value");
+
+inline constexpr melody_t FRA_MARTINO = makeMelody(FRA_MARTINO_DATA, 120);
+
+} // namespace melodies
+} // namespace simon
+
+#endif // __SIMON_MELODIES_FRA_MARTINO_H__
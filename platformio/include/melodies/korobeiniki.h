@@ -0,0 +1,29 @@
+#ifndef __SIMON_MELODIES_KOROBEINIKI_H__
+#define __SIMON_MELODIES_KOROBEINIKI_H__
+
+#include "melody.h"
+
+namespace simon {
+namespace melodies {
+
+// Korobeiniki, Russian folk song (the Tetris theme)
+inline constexpr int16_t KOROBEINIKI_SCORE[] = {
+    NOTE_E5, 4,  NOTE_B4, 8, NOTE_C5, 8, NOTE_D5, 4, NOTE_C5, 8, NOTE_B4, 8, // 1
+    NOTE_A4, 4,  NOTE_A4, 8, NOTE_C5, 8, NOTE_E5, 4, NOTE_D5, 8, NOTE_C5, 8,
+    NOTE_B4, -4, NOTE_C5, 8, NOTE_D5, 4, NOTE_E5, 4,
+    NOTE_C5, 4,  NOTE_A4, 4, NOTE_A4, 4, REST,    4,
+
+    NOTE_D5, -4, NOTE_F5, 8, NOTE_A5, 4, NOTE_G5, 8, NOTE_F5, 8, // 2
+    NOTE_E5, -4, NOTE_C5, 8, NOTE_E5, 4, NOTE_D5, 8, NOTE_C5, 8,
+    NOTE_B4, 4,  NOTE_B4, 8, NOTE_C5, 8, NOTE_D5, 4, NOTE_E5, 4,
+    NOTE_C5, 4,  NOTE_A4, 4, NOTE_A4, 4, REST,    4};
+
+inline constexpr auto KOROBEINIKI_DATA = compileMelody(KOROBEINIKI_SCORE);
+static_assert(KOROBEINIKI_DATA.valid, "Korobeiniki: unknown note or note value");
+
+inline constexpr melody_t KOROBEINIKI = makeMelody(KOROBEINIKI_DATA, 144);
+
+} // namespace melodies
+} // namespace simon
+
+#endif // __SIMON_MELODIES_KOROBEINIKI_H__
@@ -0,0 +1,25 @@
+#ifndef __SIMON_MELODIES_ODE_TO_JOY_H__
+#define __SIMON_MELODIES_ODE_TO_JOY_H__
+
+#include "melody.h"
+
+namespace simon {
+namespace melodies {
+
+// Beethoven, Symphony No. 9 (theme)
+inline constexpr int16_t ODE_TO_JOY_SCORE[] = {
+    NOTE_E5, 4, NOTE_E5, 4, NOTE_F5, 4, NOTE_G5, 4, NOTE_G5, 4,  NOTE_F5, 4, NOTE_E5, 4, NOTE_D5, 4,
+    NOTE_C5, 4, NOTE_C5, 4, NOTE_D5, 4, NOTE_E5, 4, NOTE_E5, -4, NOTE_D5, 8, NOTE_D5, 2,
+
+    NOTE_E5, 4, NOTE_E5, 4, NOTE_F5, 4, NOTE_G5, 4, NOTE_G5, 4,  NOTE_F5, 4, NOTE_E5, 4, NOTE_D5, 4,
+    NOTE_C5, 4, NOTE_C5, 4, NOTE_D5, 4, NOTE_E5, 4, NOTE_D5, -4, NOTE_C5, 8, NOTE_C5, 2};
+
+inline constexpr auto ODE_TO_JOY_DATA = compileMelody(ODE_TO_JOY_SCORE);
+static_assert(ODE_TO_JOY_DATA.valid, "Ode to Joy: unknown note or note value");
+
+inline constexpr melody_t ODE_TO_JOY = makeMelody(ODE_TO_JOY_DATA, 114);
+
+} // namespace melodies
+} // namespace simon
+
+#endif // __SIMON_MELODIES_ODE_TO_JOY_H__
@@ -1,19 +1,16 @@
 #ifndef __SIMON_MELODIES_PACMAN_H__
 #define __SIMON_MELODIES_PACMAN_H__
 
-#include "tones.h"
-#include <Arduino.h>
+#include "melody.h"
 
 namespace simon {
-
-// change this to make the song slower or faster
-int tempo = 105;
+namespace melodies {
 
 // notes of the moledy followed by the duration.
 // a 4 means a quarter note, 8 an eighteenth , 16 sixteenth, so on
 // !!negative numbers are used to represent dotted notes,
 // so -4 means a dotted quarter note, that is, a quarter plus an eighteenth!!
-int melody[] = {
+inline constexpr int16_t PACMAN_SCORE[] = {
 
     // Pacman
     // Score available at https://musescore.com/user/85429/scores/107109
@@ -25,42 +22,13 @@ int melody[] = {
     NOTE_FS5, -16, NOTE_DS5, 8,   NOTE_DS5, 32,  NOTE_E5,  32, NOTE_F5, 32, NOTE_F5, 32,
     NOTE_FS5, 32,  NOTE_G5,  32,  NOTE_G5,  32,  NOTE_GS5, 32, NOTE_A5, 16, NOTE_B5, 8};
 
-// sizeof gives the number of bytes, each int value is composed of two bytes (16 bits)
-// there are two values per note (pitch and duration), so for each note there are four bytes
-int notes = sizeof(melody) / sizeof(melody[0]) / 2;
-
-// this calculates the duration of a whole note in ms
-int wholenote = (60000 * 4) / tempo;
-
-int divider = 0, noteDuration = 0;
-
-void play_melody(int8_t pin) {
-    // iterate over the notes of the melody.
-    // Remember, the array is twice the number of notes (notes + durations)
-    for (int thisNote = 0; thisNote < notes * 2; thisNote = thisNote + 2) {
-
-        // calculates the duration of each note
-        divider = melody[thisNote + 1];
-        if (divider > 0) {
-            // regular note, just proceed
-            noteDuration = (wholenote) / divider;
-        } else if (divider < 0) {
-            // dotted notes are represented with negative durations!!
-            noteDuration = (wholenote) / abs(divider);
-            noteDuration *= 1.5; // increases the duration in half for dotted notes
-        }
-
-        // we only play the note for 90% of the duration, leaving 10% as a pause
-        tone(pin, melody[thisNote], noteDuration * 0.9);
-
-        // Wait for the specief duration before playing the next note.
-        delay(noteDuration);
+inline constexpr auto PACMAN_DATA = compileMelody(PACMAN_SCORE);
+static_assert(PACMAN_DATA.valid, "Pacman: unknown note or note value");
 
-        // stop the waveform generation before the next note.
-        noTone(pin);
-    }
-}
+// change the tempo to make the song slower or faster
+inline constexpr melody_t PACMAN = makeMelody(PACMAN_DATA, 105);
 
+} // namespace melodies
 } // namespace simon
 
-#endif // __SIMON_MELODIES_PACMAN_H__
\ No newline at end of file
+#endif // __SIMON_MELODIES_PACMAN_H__
@@ -0,0 +1,128 @@
+#ifndef __SIMON_MELODY_H__
+#define __SIMON_MELODY_H__
+
+#include "tones.h"
+#include <Arduino.h>
+
+namespace simon {
+
+#define MELODY_TICKS_WHOLE 64 // Duration ticks in a whole note (a 64th note is one tick)
+
+// Note frequencies addressed by the packed note index, 0 is a rest
+inline constexpr uint16_t NOTE_FREQUENCIES[] = {
+    REST, NOTE_B0, NOTE_C1, NOTE_CS1, NOTE_D1, NOTE_DS1, NOTE_E1, NOTE_F1, NOTE_FS1, NOTE_G1,
+    NOTE_GS1, NOTE_A1, NOTE_AS1, NOTE_B1, NOTE_C2, NOTE_CS2, NOTE_D2, NOTE_DS2, NOTE_E2, NOTE_F2,
+    NOTE_FS2, NOTE_G2, NOTE_GS2, NOTE_A2, NOTE_AS2, NOTE_B2, NOTE_C3, NOTE_CS3, NOTE_D3, NOTE_DS3,
+    NOTE_E3, NOTE_F3, NOTE_FS3, NOTE_G3, NOTE_GS3, NOTE_A3, NOTE_AS3, NOTE_B3, NOTE_C4, NOTE_CS4,
+    NOTE_D4, NOTE_DS4, NOTE_E4, NOTE_F4, NOTE_FS4, NOTE_G4, NOTE_GS4, NOTE_A4, NOTE_AS4, NOTE_B4,
+    NOTE_C5, NOTE_CS5, NOTE_D5, NOTE_DS5, NOTE_E5, NOTE_F5, NOTE_FS5, NOTE_G5, NOTE_GS5, NOTE_A5,
+    NOTE_AS5, NOTE_B5, NOTE_C6, NOTE_CS6, NOTE_D6, NOTE_DS6, NOTE_E6, NOTE_F6, NOTE_FS6, NOTE_G6,
+    NOTE_GS6, NOTE_A6, NOTE_AS6, NOTE_B6, NOTE_C7, NOTE_CS7, NOTE_D7, NOTE_DS7, NOTE_E7, NOTE_F7,
+    NOTE_FS7, NOTE_G7, NOTE_GS7, NOTE_A7, NOTE_AS7, NOTE_B7, NOTE_C8, NOTE_CS8, NOTE_D8, NOTE_DS8,
+};
+
+#define NOTE_FREQUENCIES_COUNT (sizeof(NOTE_FREQUENCIES) / sizeof(NOTE_FREQUENCIES[0]))
+
+typedef struct MelodyEvent {
+    uint8_t note;  // Index in NOTE_FREQUENCIES
+    uint8_t ticks; // Duration in 64th notes
+} melody_event_t;
+
+/**
+ * @brief A compiled melody stored in flash.
+ * Events are read in place while playing, nothing is copied to RAM.
+ */
+typedef struct Melody {
+    const melody_event_t* events;
+    uint16_t count;
+    uint32_t tick_us;     // Length of a tick at the melody tempo
+    uint32_t duration_ms; // Length of the whole melody
+} melody_t;
+
+template <size_t N> struct MelodyData {
+    melody_event_t events[N];
+    uint32_t ticks; // Sum of the event durations
+    bool valid;     // false if a note or duration could not be encoded
+};
+
+/**
+ * @brief Index of a frequency in NOTE_FREQUENCIES, 0xFF if it is not a known note.
+ */
+constexpr uint8_t noteIndex(int16_t frequency) {
+    for (uint8_t i = 0; i < NOTE_FREQUENCIES_COUNT; i++) {
+        if (NOTE_FREQUENCIES[i] == frequency) {
+            return i;
+        }
+    }
+    return 0xFF;
+}
+
+/**
+ * @brief Ticks of a note value: 4 is a quarter, 8 an eighth, negative values are dotted.
+ * @return 0 if the value cannot be represented.
+ */
+constexpr uint8_t noteTicks(int16_t divider) {
+    int16_t value = divider < 0 ? -divider : divider;
+    if (value == 0 || value > MELODY_TICKS_WHOLE || MELODY_TICKS_WHOLE % value != 0) {
+        return 0;
+    }
+
+    uint16_t ticks = MELODY_TICKS_WHOLE / value;
+    if (divider < 0) {
+        if (ticks % 2 != 0) {
+            return 0; // A dotted 64th does not fit a whole tick
+        }
+        ticks = ticks * 3 / 2;
+    }
+    return ticks;
+}
+
+/**
+ * @brief Compiles a score at build time.
+ * @param score Pairs of note frequency (NOTE_* or REST) and note value, the notation used
+ * by the Arduino melody sketches.
+ */
+template <size_t N> constexpr MelodyData<N / 2> compileMelody(const int16_t (&score)[N]) {
+    static_assert(N % 2 == 0, "A score is made of (note, value) pairs");
+
+    MelodyData<N / 2> data = {};
+    data.valid             = true;
+
+    for (size_t i = 0; i < N / 2; i++) {
+        uint8_t note  = noteIndex(score[i * 2]);
+        uint8_t ticks = noteTicks(score[i * 2 + 1]);
+        if (note == 0xFF || ticks == 0) {
+            data.valid = false;
+        }
+
+        data.events[i] = {note, ticks};
+        data.ticks += ticks;
+    }
+    return data;
+}
+
+/**
+ * @brief Binds compiled events to a tempo (quarter notes per minute).
+ */
+template <size_t N> constexpr melody_t makeMelody(const MelodyData<N>& data, uint16_t tempo) {
+    uint32_t tick_us = (60000000UL * 4 / tempo) / MELODY_TICKS_WHOLE;
+    uint32_t duration_ms = static_cast<uint64_t>(data.ticks) * tick_us / 1000;
+    return {data.events, N, tick_us, duration_ms};
+}
+
+typedef enum MelodyId {
+    MelodyPacman,      // New high score
+    MelodyOdeToJoy,    // Ode to Joy
+    MelodyKorobeiniki, // Korobeiniki
+    MelodyFraMartino,  // Fra Martino
+    MELODIES_COUNT,
+} melody_id_t;
+
+/**
+ * @brief Returns a melody of the library.
+ */
+const melody_t& melody(melody_id_t id);
+
+} // namespace simon
+
+#endif // __SIMON_MELODY_H__
@@ -0,0 +1,93 @@
+#ifndef __SIMON_MEMORY_H__
+#define __SIMON_MEMORY_H__
+
+#include "config.h"
+#include <Arduino.h>
+
+namespace simon {
+namespace Memory {
+
+typedef enum Module {
+    ModuleCore,    // Anything not attributed to a subsystem
+    ModuleGame,    // Game state, sequence, modes and statistics
+    ModuleButtons, // Button banks and callbacks
+    ModuleLeds,    // NeoPixel strip
+    ModuleBuzzer,  // Synth and sounds
+    ModuleDisplay, // SSD1306 framebuffer, text cache, scene and animations
+    ModuleFsm,     // State machine
+    MODULES_COUNT,
+} module_t;
+
+typedef struct Counters {
+    uint32_t allocations; // operator new calls
+    uint32_t frees;       // operator delete calls
+    uint32_t bytes;       // Bytes requested through operator new
+    int32_t live;         // Bytes currently allocated through operator new
+    uint32_t peak;        // High-water mark of live
+} counters_t;
+
+typedef struct ModuleUsage {
+    uint32_t static_bytes;   // Size of the module objects
+    uint32_t external_bytes; // Heap taken by libraries through malloc (measured)
+    counters_t dynamic;      // operator new / delete
+} module_usage_t;
+
+typedef struct StateUsage {
+    counters_t dynamic;     // operator new / delete while the state was active
+    uint32_t enter_free;    // Free heap when the state was last entered
+    uint32_t heap_drop;     // Largest drop of the free heap below enter_free
+    uint32_t violations;    // Allocations while the state was allocation-free
+} state_usage_t;
+
+/**
+ * @brief Attributes the allocations of a block of code to a module.
+ * Heap taken through malloc() while the scope is alive (library buffers, Arduino String)
+ * is measured from the free heap and added to the module external bytes.
+ */
+class Scope {
+  private:
+    module_t _previous;
+    uint32_t _free_heap;
+    uint32_t _new_bytes;
+
+  public:
+    Scope(module_t module);
+    ~Scope();
+};
+
+/**
+ * @brief Records the size of statically allocated module objects.
+ */
+void addStatic(module_t module, uint32_t bytes);
+
+/**
+ * @brief Tells the accounting which state is active.
+ * @param strict true if the state must not allocate; allocations are then reported as
+ * violations.
+ */
+void setState(uint8_t state, bool strict);
+
+/**
+ * @brief Samples the free heap for the per-state low-water mark and reports violations.
+ * Called from the main loop.
+ */
+void sample();
+
+const module_usage_t& module(module_t module);
+
+const state_usage_t& state(uint8_t state);
+
+/**
+ * @brief Total allocations made while an allocation-free state was active.
+ */
+uint32_t violations();
+
+/**
+ * @brief Prints the static, dynamic and heap usage of every module and state.
+ */
+void printReport();
+
+} // namespace Memory
+} // namespace simon
+
+#endif // __SIMON_MEMORY_H__
@@ -0,0 +1,192 @@
+#ifndef __SIMON_MODES_H__
+#define __SIMON_MODES_H__
+
+#include "sequence.h"
+#include "types.h"
+#include <Arduino.h>
+
+namespace simon {
+
+// -------------------------------------------
+// GameMode
+// -------------------------------------------
+
+/**
+ * @brief Rules of a game variant.
+ * The FSM states are shared by every mode: the mode only decides how the sequence
+ * grows, which part of it is replayed and which input is expected. Modes are
+ * statically allocated and keep fixed-size state, so switching allocates nothing.
+ */
+class GameMode {
+  public:
+    virtual ~GameMode() = default;
+
+    /**
+     * @brief Display name of the mode (PROGMEM string).
+     */
+    virtual const char* name() const = 0;
+
+    /**
+     * @brief Called when a new game starts, after the sequence has been cleared.
+     */
+    virtual void reset() {}
+
+    /**
+     * @brief Internal state of the mode at the start of a round, for the game snapshot.
+     */
+    virtual uint8_t saveState() const { return 0; }
+
+    /**
+     * @brief Restores a state returned by saveState(), after reset().
+     */
+    virtual void restoreState(uint8_t state) {}
+
+    /**
+     * @brief Prepares the sequence for the next round.
+     * @return false if the sequence cannot grow anymore (maximum length reached).
+     */
+    virtual bool beginRound(Sequence& seq);
+
+    /**
+     * @brief Index of the first sequence element that changed since the previous round.
+     * Only the new color by default, so the game snapshot rewrites a single byte.
+     */
+    virtual uint8_t changedFrom(const Sequence& seq) const {
+        return seq.empty() ? 0 : seq.size() - 1;
+    }
+
+    /**
+     * @brief Index of the first sequence element replayed to the player.
+     * Elements from this index to the end of the sequence are shown.
+     */
+    virtual uint8_t playbackStart(const Sequence& seq) const { return 0; }
+
+    /**
+     * @brief Number of inputs the player must enter to complete the round.
+     */
+    virtual uint8_t inputLength(const Sequence& seq) const { return seq.size(); }
+
+    /**
+     * @brief Checks the input at the given position of the round.
+     * @return true if the input is correct.
+     */
+    virtual bool checkInput(Sequence& seq, uint8_t index, color_t color) {
+        return seq[index] == color;
+    }
+
+    /**
+     * @brief Number of players taking part in the mode.
+     */
+    virtual uint8_t players() const { return 1; }
+
+    /**
+     * @brief Player expected to answer in the current round (0-based).
+     */
+    virtual uint8_t currentPlayer() const { return 0; }
+
+    /**
+     * @brief Whether all players answer at the same time, each on their own button bank.
+     */
+    virtual bool concurrent() const { return false; }
+};
+
+// -------------------------------------------
+// Modes
+// -------------------------------------------
+
+// Classic Simon: repeat the whole sequence, one new color per round
+class ClassicMode : public GameMode {
+  public:
+    const char* name() const override;
+};
+
+// The whole sequence is shown, but must be entered backwards
+class ReverseMode : public GameMode {
+  public:
+    const char* name() const override;
+
+    bool checkInput(Sequence& seq, uint8_t index, color_t color) override {
+        return seq[seq.size() - 1 - index] == color;
+    }
+};
+
+// Only the new color is shown, the rest must be remembered
+class SpeedMode : public GameMode {
+  public:
+    const char* name() const override;
+
+    uint8_t playbackStart(const Sequence& seq) const override {
+        return seq.empty() ? 0 : seq.size() - 1;
+    }
+};
+
+// A brand new random sequence, one color longer, every round
+class RandomMode : public GameMode {
+  public:
+    const char* name() const override;
+
+    bool beginRound(Sequence& seq) override;
+
+    uint8_t changedFrom(const Sequence& seq) const override { return 0; } // All new colors
+};
+
+// Players take turns: repeat the sequence, then add one color of their choice
+class AddOneMode : public GameMode {
+  private:
+    uint8_t _turn = 0;
+
+  public:
+    const char* name() const override;
+
+    void reset() override { _turn = 0; }
+
+    uint8_t saveState() const override { return _turn; }
+
+    void restoreState(uint8_t state) override { _turn = state; }
+
+    bool beginRound(Sequence& seq) override;
+
+    uint8_t playbackStart(const Sequence& seq) const override {
+        // Only the starting color is shown, afterwards the players build the sequence
+        return seq.size() == 1 ? 0 : seq.size();
+    }
+
+    uint8_t inputLength(const Sequence& seq) const override { return seq.size() + 1; }
+
+    bool checkInput(Sequence& seq, uint8_t index, color_t color) override;
+
+    uint8_t players() const override { return 2; }
+
+    uint8_t currentPlayer() const override { return _turn % players(); }
+};
+
+#if BUTTON_BANKS_COUNT > 1
+// Head-to-head: every player answers the same sequence on their own button bank
+class VersusMode : public GameMode {
+  public:
+    const char* name() const override;
+
+    uint8_t players() const override { return BUTTON_BANKS_COUNT; }
+
+    bool concurrent() const override { return true; }
+};
+#endif
+
+// -------------------------------------------
+// Registry
+// -------------------------------------------
+
+#if BUTTON_BANKS_COUNT > 1
+#define GAME_MODES_COUNT 6
+#else
+#define GAME_MODES_COUNT 5
+#endif
+
+/**
+ * @brief Returns the mode at the given index (wraps around GAME_MODES_COUNT).
+ */
+GameMode& gameMode(uint8_t index);
+
+} // namespace simon
+
+#endif // __SIMON_MODES_H__
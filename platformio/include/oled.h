@@ -0,0 +1,150 @@
+#ifndef __SIMON_OLED_H__
+#define __SIMON_OLED_H__
+
+#include "config.h"
+#include <Adafruit_SSD1306.h>
+#include <Arduino.h>
+#include <Wire.h>
+
+namespace simon {
+
+typedef struct OledBusStats {
+    uint32_t transfers;  // Flushes sent
+    uint32_t errors;     // Failed transfer attempts
+    uint32_t retries;    // Attempts repeated after an error
+    uint32_t recoveries; // Bus recoveries that found SDA held low
+    uint32_t dropped;    // Flushes given up after the retries
+    uint32_t cooldowns;  // Times the display path was disabled
+    uint8_t last_error;  // Wire::endTransmission() code of the last error
+} oled_bus_stats_t;
+
+/**
+ * @brief Partial framebuffer transfers for the SSD1306.
+ * Adafruit_SSD1306::display() always sends the full 1 KB frame. This helper sets the
+ * column/page window of the controller and only sends the bytes inside it.
+ * The loop task and the frame pipeline task both transfer: the bus, the panel state and
+ * the error counters are only touched with the bus mutex held.
+ */
+class Oled {
+  private:
+    Adafruit_SSD1306& _display;
+    TwoWire& _wire;
+    uint8_t _address;
+    bool _present          = true;    // Cleared when the display failed the self-test
+    SemaphoreHandle_t _bus = nullptr; // Created by begin(), only the loop task runs before
+
+    bool _resync                = false; // The controller missed a transfer, send everything
+    bool _on                    = true;  // Panel state, sent again on a resync
+    bool _dimmed                = false;
+    uint8_t _failures           = 0;     // Consecutive dropped transfers
+    bool _cooldown              = false; // Transfers skipped after repeated failures
+    uint32_t _cooldown_start_ms = 0;
+    oled_bus_stats_t _stats     = {};
+
+    uint8_t command(const uint8_t* commands, uint8_t count);
+
+    uint8_t transfer(const uint8_t* buffer,
+                     uint8_t first_page,
+                     uint8_t last_page,
+                     uint8_t first_column,
+                     uint8_t last_column);
+
+    /**
+     * @brief Sends the panel power and contrast, which a lost command left unknown.
+     */
+    uint8_t sendState();
+
+    /**
+     * @brief Sends commands with the same retries and cooldown as the flushes.
+     * Called with the bus mutex held.
+     */
+    void sendCommands(const uint8_t* commands, uint8_t count);
+
+    /**
+     * @brief Frees a bus held by the display (SCL pulses and a STOP) and restarts Wire.
+     */
+    void recoverBus();
+
+    bool available();
+
+    /**
+     * @brief Counts a failed attempt and prepares the next one.
+     * @return false once the retries are exhausted.
+     */
+    bool retry(uint8_t error, uint8_t attempt);
+
+    /**
+     * @brief Gives up a transfer: everything is sent again next time, and repeated
+     * failures pause the display.
+     */
+    void drop();
+
+  public:
+    Oled(Adafruit_SSD1306& display, TwoWire& wire, uint8_t address) :
+        _display(display), _wire(wire), _address(address) {}
+
+    /**
+     * @brief Bounds the Wire timeout, so a stuck bus costs a few ms per transfer, and
+     * creates the bus mutex.
+     */
+    void begin();
+
+    /**
+     * @brief Sends a rectangular window of the framebuffer.
+     * @param first_page First display page (row / 8).
+     * @param last_page Last display page, inclusive.
+     * @param first_column First column.
+     * @param last_column Last column, inclusive.
+     */
+    void flushWindow(uint8_t first_page,
+                     uint8_t last_page,
+                     uint8_t first_column,
+                     uint8_t last_column) {
+        flushBuffer(_display.getBuffer(), first_page, last_page, first_column, last_column);
+    }
+
+    /**
+     * @brief Sends a window of another buffer with the display framebuffer layout.
+     * Failed transfers are retried after a bus recovery with an increasing delay; after
+     * OLED_I2C_FAIL_LIMIT dropped flushes the display is left alone for a cooldown.
+     */
+    void flushBuffer(const uint8_t* buffer,
+                     uint8_t first_page,
+                     uint8_t last_page,
+                     uint8_t first_column,
+                     uint8_t last_column);
+
+    /**
+     * @brief Routes (or stops routing) the transfers to the display.
+     * When the display is absent every flush returns immediately.
+     */
+    void setPresent(bool present) { _present = present; }
+
+    bool present() const { return _present; }
+
+    /**
+     * @brief Lowers (or restores) the contrast, like Adafruit_SSD1306::dim().
+     */
+    void dim(bool dim);
+
+    /**
+     * @brief Turns the panel off (or back on), the controller keeps its memory.
+     */
+    void power(bool on);
+
+    /**
+     * @brief Copy of the bus statistics, consistent with a transfer in progress.
+     */
+    oled_bus_stats_t stats() const;
+
+    void printReport() const;
+
+    /**
+     * @brief Sends the whole framebuffer.
+     */
+    void flush() { flushWindow(0, SCREEN_HEIGHT / 8 - 1, 0, SCREEN_WIDTH - 1); }
+};
+
+} // namespace simon
+
+#endif // __SIMON_OLED_H__
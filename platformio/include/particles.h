@@ -0,0 +1,90 @@
+#ifndef __SIMON_PARTICLES_H__
+#define __SIMON_PARTICLES_H__
+
+#include "config.h"
+#include <Arduino.h>
+
+namespace simon {
+
+typedef enum ParticleType {
+    ParticleSpark,   // Falls with gravity, flickers before dying
+    ParticleRocket,  // Rises and bursts into sparks when its life ends
+    ParticleSparkle, // Still, twinkles in place
+} particle_type_t;
+
+// Positions and velocities are fixed point with PARTICLE_SHIFT fractional bits
+typedef struct Particle {
+    int16_t x;    // Column
+    int16_t y;    // Row
+    int8_t vx;    // Columns per frame
+    int8_t vy;    // Rows per frame
+    uint8_t life; // Frames left, 0 = free slot
+    uint8_t type; // particle_type_t
+} particle_t;
+
+/**
+ * @brief Fixed-capacity particle pool drawn straight into an SSD1306 framebuffer.
+ * Emitting into a full pool drops the particle (counted by dropped()), nothing is
+ * allocated at runtime.
+ */
+class ParticleSystem {
+  private:
+    particle_t _pool[PARTICLE_POOL_SIZE];
+    uint8_t _alive    = 0;
+    uint8_t _free     = 0; // Hint: first slot that may be free
+    uint16_t _dropped = 0;
+    uint8_t _frame    = 0;
+
+  public:
+    ParticleSystem() { clear(); }
+
+    void clear();
+
+    /**
+     * @brief Adds a particle.
+     * @param x Column in pixels.
+     * @param y Row in pixels.
+     * @param vx Horizontal velocity, fixed point.
+     * @param vy Vertical velocity, fixed point (negative goes up).
+     * @param life Number of frames the particle lives.
+     * @return false if the pool is full.
+     */
+    bool emit(particle_type_t type, int16_t x, int16_t y, int8_t vx, int8_t vy, uint8_t life);
+
+    /**
+     * @brief Emits sparks evenly spread around a point.
+     * @param speed Spark speed, fixed point.
+     * @return The number of sparks emitted.
+     */
+    uint8_t burst(int16_t x, int16_t y, uint8_t count, uint8_t speed, uint8_t life);
+
+    /**
+     * @brief Launches a rocket from the bottom of the screen.
+     * @param apex_y Row where the rocket bursts.
+     */
+    bool launch(int16_t x, int16_t apex_y);
+
+    /**
+     * @brief Adds a few sparkles at random positions.
+     */
+    void sparkle(uint8_t count, uint8_t life);
+
+    /**
+     * @brief Advances every particle by one frame.
+     */
+    void update();
+
+    /**
+     * @brief Sets the pixels of the live particles.
+     * @param buffer Framebuffer in the SSD1306 page layout.
+     */
+    void draw(uint8_t* buffer) const;
+
+    uint8_t alive() const { return _alive; }
+
+    uint16_t dropped() const { return _dropped; }
+};
+
+} // namespace simon
+
+#endif // __SIMON_PARTICLES_H__
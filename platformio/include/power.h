@@ -0,0 +1,98 @@
+#ifndef __SIMON_POWER_H__
+#define __SIMON_POWER_H__
+
+#include "config.h"
+#include "types.h"
+#include <Arduino.h>
+
+namespace simon {
+
+typedef enum PowerState {
+    PowerAwake,  // Full CPU speed, display on
+    PowerDimmed, // Reduced CPU speed, display dimmed, LEDs off
+    PowerAsleep, // Light sleep, display off
+    POWER_STATES,
+} power_state_t;
+
+#define POWER_MAX_WAKE_PINS (BUTTON_BANKS_COUNT * COLORS_COUNT + 1) // Buttons and reset
+
+/**
+ * @brief Idle power manager.
+ * Lowers the CPU frequency while the game is dimmed and puts the chip in light sleep,
+ * woken up by any of the registered (active low) button pins. The time spent in every
+ * power state is accumulated to estimate the average current drawn while idle, and the
+ * latency from the wake-up to the first frame on screen is measured.
+ */
+class Power {
+  private:
+    uint8_t _wake_pins[POWER_MAX_WAKE_PINS];
+    uint8_t _wake_count = 0;
+    uint16_t _wake_armed = 0; // Pins enabled as wake-up sources for the current sleep
+    uint32_t _cpu_mhz   = 0; // Frequency restored when waking up
+
+    power_state_t _state     = PowerAwake;
+    uint32_t _state_since_ms = 0;
+    uint32_t _residency_ms[POWER_STATES]; // Time spent in every state
+
+    uint32_t _wake_us        = 0;     // micros() of the last wake-up
+    bool _wake_pending       = false; // First frame after the wake-up not shown yet
+    uint32_t _wake_last_us   = 0;     // Wake-up to first frame latency
+    uint32_t _wake_max_us    = 0;
+    uint16_t _wakeups        = 0;
+    int8_t _wake_pin         = -1;    // Pin that ended the last light sleep
+
+    void enterState(power_state_t state);
+
+    bool armWakePins();
+
+    int8_t activeWakePin() const;
+
+  public:
+    Power();
+
+    /**
+     * @brief Records the CPU frequency to restore on wake-up.
+     */
+    void begin();
+
+    /**
+     * @brief Registers an active low pin that wakes the chip up from light sleep.
+     */
+    bool addWakePin(uint8_t pin);
+
+    power_state_t state() const { return _state; }
+
+    /**
+     * @brief Drops the CPU frequency to POWER_IDLE_CPU_MHZ.
+     */
+    void dim();
+
+    /**
+     * @brief Light sleep until a wake pin is pressed.
+     * Blocks; the peripherals (display, LEDs, synth) must be quiet before calling it.
+     * Pins that are already low are not used as wake-up sources.
+     * @return The time spent asleep in milliseconds (0 if no pin can wake the chip up).
+     */
+    uint32_t sleep();
+
+    /**
+     * @brief Pin that woke the chip up from the last light sleep.
+     */
+    int8_t wakePin() const { return _wake_pin; }
+
+    /**
+     * @brief Restores the CPU frequency and starts the wake-up latency measurement.
+     */
+    void wake();
+
+    /**
+     * @brief Ends the wake-up latency measurement, once the first frame is on screen.
+     */
+    void frameShown();
+
+    void printReport();
+};
+
+} // namespace simon
+
+#endif // __SIMON_POWER_H__
@@ -0,0 +1,97 @@
+#ifndef __SIMON_REACTION_H__
+#define __SIMON_REACTION_H__
+
+#include "config.h"
+#include <Arduino.h>
+
+namespace simon {
+
+// -------------------------------------------
+// InputSample
+// -------------------------------------------
+
+typedef struct InputSample {
+    uint32_t pressed_at;  // micros() of the press edge
+    uint32_t released_at; // micros() of the release edge (0 while still held)
+} input_sample_t;
+
+// -------------------------------------------
+// LatencyStats
+// -------------------------------------------
+
+/**
+ * @brief Aggregated reaction latency of a single player.
+ * Latencies are folded into a fixed histogram with REACTION_BUCKET_MS resolution, so
+ * min is exact while median and p95 are reported with the bucket resolution.
+ */
+class LatencyStats {
+  private:
+    uint16_t _buckets[REACTION_BUCKETS];
+    uint32_t _count  = 0;
+    uint32_t _min_us = UINT32_MAX;
+
+    uint32_t percentile(uint8_t percent) const;
+
+  public:
+    LatencyStats() { reset(); }
+
+    void reset();
+
+    void add(uint32_t latency_us);
+
+    uint32_t count() const { return _count; }
+
+    uint32_t minMs() const { return _count ? _min_us / 1000 : 0; }
+
+    uint32_t medianMs() const { return percentile(50); }
+
+    uint32_t p95Ms() const { return percentile(95); }
+};
+
+// -------------------------------------------
+// ReactionTimer
+// -------------------------------------------
+
+/**
+ * @brief Collects the press/release timestamps of the current round.
+ * The buffer is fixed in size (one slot per sequence element), so recording
+ * an input never allocates.
+ */
+class ReactionTimer {
+  private:
+    input_sample_t _samples[MAX_SEQUENCE_LENGTH];
+    uint8_t _count           = 0;
+    uint32_t _round_start_us = 0;
+
+  public:
+    ReactionTimer() = default;
+
+    /**
+     * @brief Starts a new round.
+     * @param now_us The time the player was asked for input (micros()).
+     */
+    void beginRound(uint32_t now_us);
+
+    void recordPress(uint32_t at_us);
+
+    void recordRelease(uint32_t at_us);
+
+    uint8_t count() const { return _count; }
+
+    const input_sample_t& sample(uint8_t index) const { return _samples[index]; }
+
+    /**
+     * @brief Latency of the given input: time from the previous release (or the
+     * start of the round for the first input) to the press edge.
+     */
+    uint32_t latencyUs(uint8_t index) const;
+
+    /**
+     * @brief Folds the latencies of this round into the given statistics.
+     */
+    void commit(LatencyStats& stats) const;
+};
+
+} // namespace simon
+
+#endif // __SIMON_REACTION_H__
@@ -0,0 +1,104 @@
+#ifndef __SIMON_SCENE_H__
+#define __SIMON_SCENE_H__
+
+#include "config.h"
+#include "oled.h"
+#include "sprites.h"
+#include <Adafruit_SSD1306.h>
+#include <Arduino.h>
+
+namespace simon {
+
+typedef enum WidgetType {
+    WidgetText,      // Cached (or GFX) string
+    WidgetNumber,    // Unsigned number drawn with the GFX font
+    WidgetBitmap,    // Bitmap in the SSD1306 page layout
+    WidgetAnimation, // Sequence of bitmaps cycled at a fixed period
+} widget_type_t;
+
+typedef struct Widget {
+    uint8_t type;          // widget_type_t
+    int16_t x;             // Left column, -1 to center (text only)
+    uint8_t page;          // Top display page
+    uint8_t width;         // Width of the bitmap / animation frames
+    uint8_t pages;         // Height of the bitmap / animation frames in pages
+    uint8_t drawn_x;       // Area covered by the last render
+    uint8_t drawn_width;   // (cleared before the next one)
+    uint8_t drawn_pages;   // Wrapped text covers several lines
+    bool dirty;            // Needs to be re-rasterized
+    const char* text;      // WidgetText
+    uint32_t number;       // WidgetNumber
+    const uint8_t* bitmap; // WidgetBitmap, first frame of WidgetAnimation
+    uint8_t frames;        // WidgetAnimation frame count
+    uint8_t frame;         // WidgetAnimation current frame
+    uint16_t period_ms;    // WidgetAnimation frame duration
+} widget_t;
+
+/**
+ * @brief Declarative description of a screen.
+ * Widgets are added once when a state is entered and then only updated. render() only
+ * re-rasterizes the widgets whose content changed and flushes the framebuffer columns
+ * they cover, so a screen update costs proportionally to what changed.
+ */
+class Scene {
+  private:
+    widget_t _widgets[SCENE_MAX_WIDGETS];
+    uint8_t _count = 0;
+
+    // Dirty column range of every display page (min > max means clean)
+    uint8_t _dirty_min[SCREEN_HEIGHT / 8];
+    uint8_t _dirty_max[SCREEN_HEIGHT / 8];
+    bool _clear = true; // Clear the framebuffer before the next render
+
+    int8_t addWidget(const widget_t& widget);
+
+    void markDirty(uint8_t page, uint8_t pages, uint8_t x, uint8_t width);
+
+    void rasterize(Adafruit_SSD1306& display, const TextCache& text, widget_t& widget);
+
+  public:
+    Scene() { reset(); }
+
+    /**
+     * @brief Removes every widget; the next render clears and flushes the whole screen.
+     */
+    void reset();
+
+    int8_t addText(const char* str, int16_t x, uint8_t page);
+
+    int8_t addNumber(uint32_t value, int16_t x, uint8_t page);
+
+    int8_t addBitmap(const uint8_t* bitmap, uint8_t width, uint8_t pages, int16_t x, uint8_t page);
+
+    /**
+     * @brief Adds an animation made of consecutive frames of the same size.
+     * @param frames Frame bitmaps (page layout), stored one after the other.
+     */
+    int8_t addAnimation(const uint8_t* frames,
+                        uint8_t count,
+                        uint16_t period_ms,
+                        uint8_t width,
+                        uint8_t pages,
+                        int16_t x,
+                        uint8_t page);
+
+    /**
+     * @brief Changes the string of a text widget (no-op if unchanged).
+     */
+    void setText(int8_t id, const char* str);
+
+    /**
+     * @brief Changes the value of a number widget (no-op if unchanged).
+     */
+    void setNumber(int8_t id, uint32_t value);
+
+    /**
+     * @brief Re-rasterizes the changed widgets and flushes the affected areas.
+     * @return true if anything was sent to the display.
+     */
+    bool render(Adafruit_SSD1306& display, Oled& oled, const TextCache& text, uint32_t now_ms);
+};
+
+} // namespace simon
+
+#endif // __SIMON_SCENE_H__
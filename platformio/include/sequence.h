@@ -0,0 +1,51 @@
+#ifndef __SIMON_SEQUENCE_H__
+#define __SIMON_SEQUENCE_H__
+
+#include "config.h"
+#include "types.h"
+#include <Arduino.h>
+
+namespace simon {
+
+/**
+ * @brief Fixed-capacity sequence of colors.
+ * Storage is sized by MAX_SEQUENCE_LENGTH so adding colors never allocates.
+ */
+class Sequence {
+  private:
+    color_t _colors[MAX_SEQUENCE_LENGTH];
+    uint8_t _size = 0;
+
+  public:
+    Sequence() = default;
+
+    void clear() { _size = 0; }
+
+    /**
+     * @brief Appends a color to the sequence.
+     * @return false if the sequence is already full.
+     */
+    bool push(color_t color) {
+        if (full()) {
+            return false;
+        }
+        _colors[_size++] = color;
+        return true;
+    }
+
+    uint8_t size() const { return _size; }
+
+    bool empty() const { return _size == 0; }
+
+    bool full() const { return _size >= MAX_SEQUENCE_LENGTH; }
+
+    color_t operator[](uint8_t index) const { return _colors[index]; }
+
+    const color_t* begin() const { return _colors; }
+
+    const color_t* end() const { return _colors + _size; }
+};
+
+} // namespace simon
+
+#endif // __SIMON_SEQUENCE_H__
@@ -0,0 +1,88 @@
+#ifndef __SIMON_SETTINGS_H__
+#define __SIMON_SETTINGS_H__
+
+#include "config.h"
+#include "types.h"
+#include <Arduino.h>
+
+namespace simon {
+
+/**
+ * @brief Runtime configuration.
+ * Starts from the config.h defaults and can be overridden from NVS at boot. Subsystems get
+ * it by reference and copy the values they use in their hot paths when they are set up
+ * (and again through their configure() method when it changes).
+ */
+typedef struct Config {
+    // Pins (applied at boot)
+    uint16_t led_pin;
+    uint16_t led_count;
+    uint16_t led_layout; // LED_LAYOUT_*
+    uint16_t led_width;
+    uint16_t led_offset;
+    uint16_t buzzer_pin;
+    uint16_t reset_button_pin;
+    int8_t button_pins[BUTTON_BANKS_COUNT][COLORS_COUNT];
+
+    // LEDs and sound
+    uint16_t led_brightness;
+    uint16_t volume;
+    uint16_t success_tone_ms;
+
+    // Timing
+    uint16_t debounce_ms;
+    uint16_t input_timeout_ms;
+    uint16_t mode_select_hold_ms;
+    uint16_t idle_page_ms;
+    uint16_t idle_rainbow_ms;
+    uint16_t power_dim_s;
+    uint16_t power_sleep_s;
+} config_t;
+
+namespace Settings {
+
+typedef struct Field {
+    const char* name; // NVS key and console name
+    uint16_t Config::*value;
+    uint16_t min;
+    uint16_t max;
+    bool boot; // Only applied at boot
+} field_t;
+
+/**
+ * @brief The compile-time defaults from config.h.
+ */
+config_t defaults();
+
+/**
+ * @brief Applies the values saved in NVS, then validates the result.
+ * @return false if NVS could not be read (the defaults are kept).
+ */
+bool load(config_t& config);
+
+/**
+ * @brief Saves every value to NVS.
+ */
+bool save(const config_t& config);
+
+/**
+ * @brief Replaces the out of range values with their defaults.
+ * @return false if anything had to be replaced.
+ */
+bool validate(config_t& config);
+
+uint8_t fieldsCount();
+
+const field_t& field(uint8_t index);
+
+/**
+ * @brief Looks a field up by name, nullptr if it does not exist.
+ */
+const field_t* find(const char* name);
+
+void print(const config_t& config, const field_t& field);
+
+} // namespace Settings
+} // namespace simon
+
+#endif // __SIMON_SETTINGS_H__
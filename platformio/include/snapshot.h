@@ -0,0 +1,53 @@
+#ifndef __SIMON_SNAPSHOT_H__
+#define __SIMON_SNAPSHOT_H__
+
+#include "config.h"
+#include "sequence.h"
+#include <Arduino.h>
+
+namespace simon {
+
+/**
+ * @brief State of a game at the start of a round, besides its sequence.
+ */
+typedef struct GameSnapshot {
+    uint8_t mode;                // Index of the game mode
+    uint8_t mode_state;          // GameMode::saveState()
+    uint8_t out;                 // One bit per player out of the game
+    uint8_t scores[MAX_PLAYERS]; // Score of the players who went out
+} game_snapshot_t;
+
+/**
+ * @brief Game state kept in RTC memory, which survives software resets, panics,
+ * watchdog resets and brownouts (but not a power cycle), so an interrupted game can
+ * resume right after the reboot. Colors are packed 2 bits each. A round writes the
+ * header, the byte holding the new color and a CRC of fixed cost: complete color bytes
+ * are added once to a running CRC of their own.
+ * A round is resumed once: if the board resets again before the next round is saved,
+ * the record is dropped instead of looping on a round that keeps crashing.
+ */
+namespace Snapshot {
+
+/**
+ * @brief Records the state at the start of a round.
+ * @param changed_from First color that changed since the last save
+ * (GameMode::changedFrom()), 0 to write the whole sequence.
+ */
+void save(const game_snapshot_t& game, const Sequence& sequence, uint8_t changed_from = 0);
+
+/**
+ * @brief Reads the recorded state back and counts the resume.
+ * @return false if there is no game to resume: nothing recorded, corrupted record, a
+ * reset that does not keep the RTC memory, or a round that was already resumed.
+ */
+bool restore(game_snapshot_t& game, Sequence& sequence);
+
+/**
+ * @brief Forgets the recorded game (it ended).
+ */
+void discard();
+
+} // namespace Snapshot
+} // namespace simon
+
+#endif // __SIMON_SNAPSHOT_H__
@@ -0,0 +1,81 @@
+#ifndef __SIMON_SPRITES_H__
+#define __SIMON_SPRITES_H__
+
+#include "config.h"
+#include <Adafruit_SSD1306.h>
+#include <Arduino.h>
+
+namespace simon {
+
+typedef struct TextSprite {
+    const char* key; // PROGMEM string the sprite was rendered from
+    uint16_t offset; // Offset of the bitmap in the cache pool
+    uint8_t width;   // Width in pixels (columns)
+    uint8_t pages;   // Height in 8-pixel display pages
+} text_sprite_t;
+
+/**
+ * @brief Cache of pre-rendered text bitmaps.
+ * Strings are rasterized once at boot in the SSD1306 page layout (one byte per column
+ * covers 8 rows), so drawing a cached string on a page-aligned line is a memcpy per page
+ * instead of per-glyph GFX calls. Sprites are looked up by the address of their string.
+ */
+class TextCache {
+  private:
+    uint8_t _pool[TEXT_CACHE_BYTES];
+    text_sprite_t _sprites[TEXT_CACHE_SPRITES];
+    uint16_t _used = 0;
+    uint8_t _count = 0;
+    uint8_t _size  = 2;
+
+  public:
+    TextCache() = default;
+
+    /**
+     * @brief Rasterizes a string and adds it to the cache.
+     * Strings wider than the screen wrap onto the next lines like GFX text does, the
+     * sprite then covers the pages of every line.
+     * @param str The PROGMEM string, also used as lookup key.
+     * @return false if the cache is full.
+     */
+    bool add(const char* str);
+
+    /**
+     * @brief Size of a string once drawn, wrapped at the screen width.
+     * @param str The PROGMEM string.
+     * @param width Width in pixels of the widest line.
+     * @param pages Height in display pages of all the lines.
+     */
+    void measure(const char* str, uint8_t& width, uint8_t& pages) const;
+
+    /**
+     * @brief Finds the sprite rendered from the given string.
+     * @return nullptr if the string is not cached.
+     */
+    const text_sprite_t* find(const char* str) const;
+
+    /**
+     * @brief Text size used to render the sprites (and by the GFX fallback).
+     */
+    uint8_t textSize() const { return _size; }
+
+    /**
+     * @brief Copies a sprite into the display buffer.
+     * Falls back to GFX text drawing when the string is not cached.
+     * @param display The display whose buffer is written.
+     * @param str The string to draw.
+     * @param x Left column, or -1 to center horizontally.
+     * @param page Display page (row / 8) of the top of the text.
+     */
+    void draw(Adafruit_SSD1306& display, const char* str, int16_t x, uint8_t page) const;
+
+    void drawCentered(Adafruit_SSD1306& display, const char* str, uint8_t page) const {
+        draw(display, str, -1, page);
+    }
+
+    uint16_t bytesUsed() const { return _used; }
+};
+
+} // namespace simon
+
+#endif // __SIMON_SPRITES_H__
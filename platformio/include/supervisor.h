@@ -0,0 +1,78 @@
+#ifndef __SIMON_SUPERVISOR_H__
+#define __SIMON_SUPERVISOR_H__
+
+#include "config.h"
+#include <Arduino.h>
+
+namespace simon {
+namespace Supervisor {
+
+typedef enum ScopeId {
+    ScopeNone,
+    ScopeConsole,     // Serial console input
+    ScopeButtons,     // Button scan and the press / release callbacks
+    ScopeTimers,      // Timer wheel callbacks
+    ScopeState,       // Loop of the current FSM state
+    ScopeLeds,        // NeoPixel frame output
+    ScopeDisplay,     // SSD1306 transfers
+    ScopeStorage,     // NVS reads and writes
+    ScopeCelebration, // High score celebration
+    ScopeSleep,       // Light sleep
+    SCOPES_COUNT,
+} scope_id_t;
+
+/**
+ * @brief Marks a subsystem call as active on the main loop task.
+ * Markers are stored in RTC memory as they are entered, so when the watchdog resets a
+ * stalled loop the next boot can tell where it was stuck. Calls from other tasks (the
+ * display transfer task) are not recorded.
+ */
+class Scope {
+  private:
+    bool _recorded;
+
+  public:
+    Scope(scope_id_t scope);
+    ~Scope();
+};
+
+/**
+ * @brief Prints the record left by a watchdog or panic reset, then starts a new one.
+ * Called first thing at boot, before any scope is entered.
+ */
+void begin();
+
+/**
+ * @brief Subscribes the main loop task to the task watchdog (SUPERVISOR_WDT_MS).
+ * From here on loopEnd() feeds it, the loop iterations must never block for long.
+ */
+void startWatchdog();
+
+/**
+ * @brief Starts a main loop iteration in the given FSM state.
+ */
+void loopStart(uint8_t state);
+
+/**
+ * @brief Ends a main loop iteration: tracks its duration and feeds the watchdog.
+ */
+void loopEnd();
+
+/**
+ * @brief Updates the FSM state of the record when it changes in an iteration.
+ */
+void setState(uint8_t state);
+
+/**
+ * @brief Unsubscribes the loop task for a sleep whose length the watchdog cannot know.
+ */
+void suspend();
+
+void resume();
+
+void printReport();
+
+} // namespace Supervisor
+} // namespace simon
+
+#endif // __SIMON_SUPERVISOR_H__
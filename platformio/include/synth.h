@@ -0,0 +1,134 @@
+#ifndef __SIMON_SYNTH_H__
+#define __SIMON_SYNTH_H__
+
+#include "config.h"
+#include "melody.h"
+#include "types.h"
+#include <Arduino.h>
+#include <esp_timer.h>
+
+namespace simon {
+
+// Higher priorities preempt lower ones; the preempted sound keeps its timing muted
+typedef enum SoundPriority {
+    SoundMelody,   // Background music
+    SoundFeedback, // Button and sequence tones
+    SoundAlert,    // Error sound
+    SOUND_PRIORITIES,
+} sound_priority_t;
+
+typedef struct SynthStep {
+    uint16_t note;   // Frequency in Hz, 0 for a rest
+    uint16_t on_ms;  // Note length, 0 = hold until stopped
+    uint16_t off_ms; // Silence after the note
+} synth_step_t;
+
+typedef struct SynthEnvelope {
+    uint16_t attack_ms;  // Rise from silence to full level
+    uint16_t decay_ms;   // Fall from full level to the sustain level
+    uint8_t sustain;     // Level held until the note ends (0-255)
+    uint16_t release_ms; // Fade out after the note, within its off time
+} synth_envelope_t;
+
+typedef struct SynthSound {
+    const synth_step_t* steps;
+    uint8_t count;
+    const synth_envelope_t* envelope;
+} synth_sound_t;
+
+/**
+ * @brief PWM synthesizer for the buzzer.
+ * A periodic timer steps through the sounds of every priority level, shapes the level of
+ * the highest active one with its envelope and sets the LEDC duty cycle accordingly (50%
+ * duty is the loudest square wave). Everything in the timer path is integer math.
+ */
+class Synth {
+  private:
+    typedef struct Voice {
+        const synth_step_t* steps;     // Step table, or
+        const melody_t* melody;        // compiled melody read in place
+        const synth_envelope_t* envelope;
+        synth_step_t live;             // Step storage for single tones
+        synth_step_t step;             // Current step (decoded melody event)
+        uint16_t count;
+        uint16_t index;                // Current step
+        uint16_t elapsed_ms;           // Time since the start of the current step
+        bool active;
+    } voice_t;
+
+    int8_t _pin     = -1;
+    uint8_t _volume = SYNTH_DEFAULT_VOLUME;
+    voice_t _voices[SOUND_PRIORITIES];
+    esp_timer_handle_t _timer = nullptr;
+    portMUX_TYPE _lock        = portMUX_INITIALIZER_UNLOCKED;
+
+    // Last values written to the LEDC peripheral
+    uint16_t _out_note = 0;
+    uint16_t _out_duty = 0;
+
+    static void onTick(void* arg);
+
+    void tick();
+
+    static uint8_t envelopeLevel(const synth_envelope_t& envelope, uint16_t elapsed_ms);
+
+    static void loadStep(voice_t& voice);
+
+    void start(sound_priority_t priority,
+               const synth_step_t* steps,
+               const melody_t* melody,
+               uint16_t count,
+               const synth_envelope_t* envelope);
+
+  public:
+    Synth();
+
+    /**
+     * @brief Attaches the LEDC channel to the pin and starts the synth timer.
+     * @return false if the timer could not be created.
+     */
+    bool begin(int8_t pin);
+
+    /**
+     * @brief Plays a sound, replacing the one playing at the same priority.
+     */
+    void play(const synth_sound_t& sound, sound_priority_t priority);
+
+    /**
+     * @brief Streams a compiled melody from flash.
+     */
+    void play(const melody_t& melody, sound_priority_t priority = SoundMelody);
+
+    /**
+     * @brief Plays a single note.
+     * @param duration_ms Note length, 0 to hold it until stop() is called.
+     */
+    void tone(note_t note, uint16_t duration_ms = 0, sound_priority_t priority = SoundFeedback);
+
+    void stop(sound_priority_t priority);
+
+    void stopAll();
+
+    /**
+     * @brief Silences the output and stops the synth timer (before a light sleep).
+     */
+    void suspend();
+
+    /**
+     * @brief Restarts the synth timer after suspend().
+     */
+    void resume();
+
+    bool isPlaying(sound_priority_t priority) const { return _voices[priority].active; }
+
+    /**
+     * @brief Output volume, 0 (mute) to 255 (full).
+     */
+    void setVolume(uint8_t volume) { _volume = volume; }
+
+    uint8_t volume() const { return _volume; }
+};
+
+} // namespace simon
+
+#endif // __SIMON_SYNTH_H__
@@ -0,0 +1,125 @@
+#ifndef __SIMON_TIMELINE_H__
+#define __SIMON_TIMELINE_H__
+
+#include "config.h"
+#include "difficulty.h"
+#include "sequence.h"
+#include "types.h"
+#include <Arduino.h>
+
+namespace simon {
+
+typedef enum TimelineActionType {
+    ActionLedOn,   // Show the color segment given by arg
+    ActionLedOff,  // Clear the LEDs
+    ActionToneOn,  // Start the tone of the color given by arg
+    ActionToneOff, // Stop the buzzer
+    ActionDisplay, // Show the name of the color given by arg
+    ActionEnd,     // Nothing to do, marks the end of the timeline
+} timeline_action_type_t;
+
+typedef struct TimelineAction {
+    uint16_t delay_ms; // Delay from the previous action
+    uint8_t type;      // timeline_action_type_t
+    uint8_t arg;       // Action argument (color)
+} timeline_action_t;
+
+// -------------------------------------------
+// Timeline
+// -------------------------------------------
+
+/**
+ * @brief Flat list of timestamped actions.
+ * Each action stores its delay from the previous one, so the nominal schedule is the
+ * running sum of the delays. Storage is fixed in size.
+ */
+class Timeline {
+  private:
+    timeline_action_t _actions[TIMELINE_MAX_ACTIONS];
+    uint16_t _size        = 0;
+    uint32_t _duration_ms = 0;
+
+  public:
+    Timeline() = default;
+
+    void clear();
+
+    /**
+     * @brief Appends an action.
+     * @param delay_ms Delay from the previous action in milliseconds.
+     * @return false if the timeline is full.
+     */
+    bool add(uint16_t delay_ms, timeline_action_type_t type, uint8_t arg = 0);
+
+    uint16_t size() const { return _size; }
+
+    uint32_t durationMs() const { return _duration_ms; }
+
+    const timeline_action_t& operator[](uint16_t index) const { return _actions[index]; }
+};
+
+/**
+ * @brief Compiles the playback of a sequence into a timeline.
+ * @param timeline The timeline to fill (cleared first).
+ * @param sequence The sequence to play.
+ * @param first Index of the first element to play.
+ * @param timing Per-step durations.
+ * @param lead_in_ms Pause before the first element.
+ */
+void compileSequence(Timeline& timeline,
+                     const Sequence& sequence,
+                     uint8_t first,
+                     const step_timing_t& timing,
+                     uint16_t lead_in_ms);
+
+// -------------------------------------------
+// TimelinePlayer
+// -------------------------------------------
+
+/**
+ * @brief Executes a timeline without blocking.
+ * poll() is called from the main loop and hands out the actions that are due. The
+ * lateness of each action against the nominal schedule is recorded as jitter.
+ */
+class TimelinePlayer {
+  private:
+    const Timeline* _timeline = nullptr;
+    uint16_t _next            = 0;
+    uint32_t _start_us        = 0;
+    uint32_t _due_ms          = 0; // Nominal time of the next action since start
+
+    uint32_t _jitter_max_us   = 0;
+    uint32_t _jitter_total_us = 0;
+    uint16_t _jitter_count    = 0;
+
+  public:
+    TimelinePlayer() = default;
+
+    /**
+     * @brief Starts playing the given timeline.
+     * @param timeline The timeline to play, must outlive the playback.
+     * @param now_us The current time (micros()).
+     */
+    void start(const Timeline& timeline, uint32_t now_us);
+
+    void stop() { _timeline = nullptr; }
+
+    bool isPlaying() const { return _timeline != nullptr; }
+
+    /**
+     * @brief Returns the next due action, if any.
+     * Call repeatedly until it returns false: several actions may be due at once.
+     * The playback stops automatically after the last action.
+     */
+    bool poll(uint32_t now_us, timeline_action_t& action);
+
+    uint32_t jitterMaxUs() const { return _jitter_max_us; }
+
+    uint32_t jitterAvgUs() const { return _jitter_count ? _jitter_total_us / _jitter_count : 0; }
+
+    uint16_t jitterCount() const { return _jitter_count; }
+};
+
+} // namespace simon
+
+#endif // __SIMON_TIMELINE_H__
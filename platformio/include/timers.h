@@ -0,0 +1,80 @@
+#ifndef __SIMON_TIMERS_H__
+#define __SIMON_TIMERS_H__
+
+#include "config.h"
+#include "delegate.h"
+#include <Arduino.h>
+
+namespace simon {
+
+#define TIMER_NONE  -1   // End of a slot list
+#define TIMER_STATE 0xFF // Timer not bound to a state
+
+typedef struct WheelTimer {
+    uint32_t rounds;    // Wheel revolutions left before expiry
+    uint32_t period;    // Ticks between expiries, 0 for one-shot timers
+    int8_t next;        // Next timer in the same slot
+    int8_t prev;        // Previous timer in the same slot
+    uint8_t slot;       // Wheel slot
+    uint8_t state;      // FSM state that owns the timer, or TIMER_STATE
+    bool armed;
+    bool pending;       // Expired, not reported yet
+} wheel_timer_t;
+
+/**
+ * @brief Hashed timer wheel.
+ * Timers are identified by a small fixed id and hang off the wheel slot of their expiry
+ * tick, so arming and cancelling are O(1) and poll() only looks at the slots of the ticks
+ * that elapsed, whatever the number of armed timers. Expired timers are reported through
+ * the callback after the slot has been processed, so the callback may arm and cancel
+ * timers freely.
+ */
+class TimerWheel {
+  public:
+    typedef Delegate<void(uint8_t id)> CallbackFunction;
+
+  private:
+    wheel_timer_t _timers[TIMER_WHEEL_TIMERS];
+    int8_t _slots[TIMER_WHEEL_SLOTS]; // First timer of each slot
+    uint32_t _tick    = 0;            // Ticks processed so far
+    uint32_t _last_ms = 0;            // millis() of the last processed tick
+    CallbackFunction _expired_cb = nullptr;
+
+    void link(uint8_t id, uint32_t ticks);
+
+    void unlink(uint8_t id);
+
+  public:
+    TimerWheel();
+
+    void begin(uint32_t now_ms);
+
+    void setExpiredCallback(CallbackFunction cb) { _expired_cb = cb; }
+
+    /**
+     * @brief Arms (or re-arms) a timer.
+     * @param id Timer id, below TIMER_WHEEL_TIMERS.
+     * @param delay_ms Time until the first expiry.
+     * @param state FSM state the timer belongs to (cancelled when it exits), or TIMER_STATE.
+     * @param period_ms Repeat period, 0 for a one-shot timer.
+     */
+    void arm(uint8_t id, uint32_t delay_ms, uint8_t state = TIMER_STATE, uint32_t period_ms = 0);
+
+    void cancel(uint8_t id);
+
+    /**
+     * @brief Cancels every timer owned by a state.
+     */
+    void cancelState(uint8_t state);
+
+    bool isArmed(uint8_t id) const { return id < TIMER_WHEEL_TIMERS && _timers[id].armed; }
+
+    /**
+     * @brief Advances the wheel to the current time and reports the expired timers.
+     */
+    void poll(uint32_t now_ms);
+};
+
+} // namespace simon
+
+#endif // __SIMON_TIMERS_H__
@@ -17,7 +17,12 @@ typedef enum Color {
 
 #define COLORS_COUNT 4
 
-String colorToString(simon::color_t color);
+const __FlashStringHelper* colorToString(simon::color_t color);
+
+/**
+ * @brief Name of the color as a PROGMEM string (no allocation).
+ */
+const char* colorToName(simon::color_t color);
 
 uint32_t colorToRGB(simon::color_t color);
 
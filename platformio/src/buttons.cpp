@@ -30,25 +30,29 @@ bool Button::readDigitalPin() {
     return digitalRead(_pin) == LOW; // Buttons pull to ground when pressed
 }
 
-void Button::updateState() {
-    bool current_reading = readDigitalPin();
-
+void Button::updateState(bool reading,
+                         unsigned long now_ms,
+                         uint32_t now_us,
+                         uint16_t debounce_ms) {
     // If the reading changed, reset debounce timer
-    if (current_reading != _last_state) {
-        _last_debounce_time = millis();
-        _last_state = current_reading;
+    if (reading != _last_state) {
+        _last_debounce_time = now_ms;
+        _last_edge_us       = now_us;
+        _last_state         = reading;
     }
 
     // If stable for debounce delay, update button state
-    if ((millis() - _last_debounce_time) > BUTTONS_DEBOUNCE_DELAY) {
-        if (current_reading && !_is_pressed) {
+    if ((now_ms - _last_debounce_time) > debounce_ms) {
+        if (reading && !_is_pressed) {
             // Button just pressed
-            _is_pressed = true;
-            _is_tapped = false;
-        } else if (!current_reading && _is_pressed) {
+            _is_pressed    = true;
+            _is_tapped     = false;
+            _pressed_at_us = _last_edge_us;
+        } else if (!reading && _is_pressed) {
             // Button just released
-            _is_pressed = false;
-            _is_tapped = true;
+            _is_pressed     = false;
+            _is_tapped      = true;
+            _released_at_us = _last_edge_us;
         }
     }
 }
@@ -57,21 +61,74 @@ void Button::updateState() {
 // Buttons
 // -------------------------------------------
 
+static const color_t bank_colors[COLORS_COUNT] = {
+    color_t::ColorRed, color_t::ColorGreen, color_t::ColorBlue, color_t::ColorYellow};
+
+static const char* const bank_names[COLORS_COUNT] = {"red", "green", "blue", "yellow"};
+
+Buttons::Buttons(const config_t& config) : _config(config) {
+    for (uint8_t bank = 0; bank < BUTTON_BANKS_COUNT; bank++) {
+        for (uint8_t i = 0; i < COLORS_COUNT; i++) {
+            // Pins of each bank are in the order of bank_colors
+            _buttons[bank][i] =
+                Button(bank_names[i], bank_colors[i], _config.button_pins[bank][i], bank);
+        }
+        _pressed_button[bank] = nullptr;
+        _tapped_button[bank]  = nullptr;
+        _injected[bank]       = 0;
+    }
+}
+
 void Buttons::setup() {
-    // Configure all button pins as input with pullup resistors
-    pinMode(RED_BUTTON_PIN, INPUT_PULLUP);
-    pinMode(GREEN_BUTTON_PIN, INPUT_PULLUP);
-    pinMode(BLUE_BUTTON_PIN, INPUT_PULLUP);
-    pinMode(YELLOW_BUTTON_PIN, INPUT_PULLUP);
-
-    _pressed_button = nullptr;
-    _tapped_button  = nullptr;
-
-    // Reset all button states
-    _red_button.reset();
-    _green_button.reset();
-    _blue_button.reset();
-    _yellow_button.reset();
+    for (uint8_t bank = 0; bank < BUTTON_BANKS_COUNT; bank++) {
+        for (uint8_t i = 0; i < COLORS_COUNT; i++) {
+            // The pins may have been changed since the construction
+            _buttons[bank][i] =
+                Button(bank_names[i], bank_colors[i], _config.button_pins[bank][i], bank);
+        }
+
+        for (auto& button : _buttons[bank]) {
+            // Configure the button pin as input with pullup resistor
+            pinMode(button.getPin(), INPUT_PULLUP);
+
+            // Reset the button state
+            button.reset();
+        }
+
+        _pressed_button[bank] = nullptr;
+        _tapped_button[bank]  = nullptr;
+        _injected[bank]       = 0;
+    }
+
+    configure();
+}
+
+void Buttons::inject(uint8_t bank, uint8_t index, bool pressed) {
+    if (bank >= BUTTON_BANKS_COUNT || index >= COLORS_COUNT) {
+        return;
+    }
+
+    if (pressed) {
+        _injected[bank] |= 1 << index;
+    } else {
+        _injected[bank] &= ~(1 << index);
+    }
+}
+
+void Buttons::configure() { _debounce_ms = _config.debounce_ms; }
+
+uint16_t Buttons::selfTest() {
+    uint16_t stuck = 0;
+    for (uint8_t bank = 0; bank < BUTTON_BANKS_COUNT; bank++) {
+        for (uint8_t i = 0; i < COLORS_COUNT; i++) {
+            Button& button = _buttons[bank][i];
+            button.setEnabled(!button.readDigitalPin());
+            if (!button.isEnabled()) {
+                stuck |= 1 << (bank * COLORS_COUNT + i);
+            }
+        }
+    }
+    return stuck;
 }
 
 void Buttons::loop() {
@@ -80,48 +137,79 @@ void Buttons::loop() {
 }
 
 void Buttons::pause() {
-    _paused         = true;
-    _pressed_button = nullptr;
-    _tapped_button  = nullptr;
+    _paused = true;
+    for (uint8_t bank = 0; bank < BUTTON_BANKS_COUNT; bank++) {
+        _pressed_button[bank] = nullptr;
+        _tapped_button[bank]  = nullptr;
+    }
 }
 
 void Buttons::resume() { _paused = false; }
 
 void Buttons::process_internal() {
-    // Update all button states
-    _red_button.updateState();
-    _green_button.updateState();
-    _blue_button.updateState();
-    _yellow_button.updateState();
+    // Sample every pin of every bank against the same tick, so that no player
+    // gets an advantage from being read first
+    bool readings[BUTTON_BANKS_COUNT][COLORS_COUNT];
+    unsigned long now_ms = millis();
+    uint32_t now_us      = micros();
+
+    for (uint8_t bank = 0; bank < BUTTON_BANKS_COUNT; bank++) {
+        for (uint8_t i = 0; i < COLORS_COUNT; i++) {
+            readings[bank][i] =
+                _buttons[bank][i].readDigitalPin() || (_injected[bank] & (1 << i));
+        }
+    }
 
-    // Check for newly pressed buttons
-    Button* buttons[] = {&_red_button, &_green_button, &_blue_button, &_yellow_button};
+    for (uint8_t bank = 0; bank < BUTTON_BANKS_COUNT; bank++) {
+        for (uint8_t i = 0; i < COLORS_COUNT; i++) {
+            Button& button = _buttons[bank][i];
+            if (!button.isEnabled()) {
+                if (readings[bank][i]) {
+                    continue; // Still held (or stuck) since boot
+                }
+                button.setEnabled(true);
+            }
+            button.updateState(readings[bank][i], now_ms, now_us, _debounce_ms);
+        }
+    }
+
+    // Rotate the bank whose callbacks run first, so simultaneous events are not
+    // always resolved in favour of the same player. A callback that ends the round
+    // pauses the buttons, the remaining banks are then ignored too
+    for (uint8_t n = 0; n < BUTTON_BANKS_COUNT && !_paused; n++) {
+        process_bank((_first_bank + n) % BUTTON_BANKS_COUNT);
+    }
+    _first_bank = (_first_bank + 1) % BUTTON_BANKS_COUNT;
+}
+
+void Buttons::process_bank(uint8_t bank) {
+    for (Button& btn : _buttons[bank]) {
+        Button* button = &btn;
 
-    for (Button* button : buttons) {
         // Check for button press events
-        if (button->isPressed() && _pressed_button != button) {
+        if (button->isPressed() && _pressed_button[bank] != button) {
             // New button pressed
-            if (_pressed_button != nullptr) {
+            if (_pressed_button[bank] != nullptr) {
                 // Release previous button if any
-                _pressed_button->setPressed(false);
+                _pressed_button[bank]->setPressed(false);
             }
 
-            _pressed_button = button;
-            _tapped_button = nullptr; // Clear tapped state
+            _pressed_button[bank] = button;
+            _tapped_button[bank]  = nullptr; // Clear tapped state
 
             if (pressed_cb) {
-                pressed_cb(*_pressed_button);
+                pressed_cb(*_pressed_button[bank]);
             }
         }
 
         // Check for button release events
-        if (button->isTapped() && _pressed_button == button) {
+        if (button->isTapped() && _pressed_button[bank] == button) {
             // Button was released
-            _pressed_button = nullptr;
-            _tapped_button = button;
+            _pressed_button[bank] = nullptr;
+            _tapped_button[bank]  = button;
 
             if (released_cb) {
-                released_cb(*_tapped_button);
+                released_cb(*_tapped_button[bank]);
             }
 
             // Clear tapped state after handling
@@ -130,6 +218,10 @@ void Buttons::process_internal() {
     }
 }
 
-bool Buttons::isTapped() { return _tapped_button != nullptr && _tapped_button->isTapped(); }
+bool Buttons::isTapped(uint8_t bank) {
+    return _tapped_button[bank] != nullptr && _tapped_button[bank]->isTapped();
+}
 
-bool Buttons::isPressed() { return _pressed_button != nullptr && _pressed_button->isPressed(); }
+bool Buttons::isPressed(uint8_t bank) {
+    return _pressed_button[bank] != nullptr && _pressed_button[bank]->isPressed();
+}
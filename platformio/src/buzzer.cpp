@@ -1,80 +1,99 @@
 
 #include "buzzer.h"
 #include "config.h"
-#include "melodies/pacman.h"
+#include "melody.h"
 #include "tones.h"
 #include <Arduino.h>
 
 namespace simon {
 
-void Buzzer::_tone(uint16_t note, uint16_t duration) { tone(_pin, note, duration); } // _tone
-
-void Buzzer::setup() { pinMode(_pin, OUTPUT); } // setup
+// Envelopes
+static const synth_envelope_t ENVELOPE_CHIME  = {2, 40, 160, 10};
+static const synth_envelope_t ENVELOPE_ERROR  = {10, 200, 180, 60};
+
+// Sounds
+static const synth_step_t INITIAL_STEPS[] = {
+    {NOTE_C5, 80, 30},
+    {NOTE_E5, 80, 30},
+    {NOTE_G5, 80, 30},
+    {NOTE_C5, 80, 30},
+    {NOTE_E5, 80, 30},
+    {NOTE_G5, 80, 30},
+    {NOTE_C6, 80, 0},
+};
+
+static const synth_step_t ROUND_WIN_STEPS[] = {
+    {NOTE_C5, 60, 20},
+    {NOTE_E5, 60, 20},
+    {NOTE_G5, 60, 20},
+    {NOTE_C5, 60, 20},
+    {NOTE_E5, 60, 20},
+    {NOTE_G5, 60, 20},
+    {NOTE_C6, 60, 0},
+};
+
+static const synth_step_t SUCCESS_STEPS[] = {
+    {NOTE_E5, SUCCESS_TONE_DURATION, 0},
+    {NOTE_G5, SUCCESS_TONE_DURATION, 0},
+    {NOTE_E6, SUCCESS_TONE_DURATION, 0},
+    {NOTE_D6, SUCCESS_TONE_DURATION, 0},
+    {NOTE_G6, SUCCESS_TONE_DURATION, 0},
+};
+
+static const synth_step_t ERROR_STEPS[] = {
+    {NOTE_A2, ERROR_TONE_DURATION, 0},
+};
+
+#define SOUND(steps, envelope) {steps, sizeof(steps) / sizeof(steps[0]), &envelope}
+
+static const synth_sound_t INITIAL_SOUND   = SOUND(INITIAL_STEPS, ENVELOPE_CHIME);
+static const synth_sound_t ROUND_WIN_SOUND = SOUND(ROUND_WIN_STEPS, ENVELOPE_CHIME);
+static const synth_sound_t SUCCESS_SOUND   = SOUND(SUCCESS_STEPS, ENVELOPE_CHIME);
+static const synth_sound_t ERROR_SOUND     = SOUND(ERROR_STEPS, ENVELOPE_ERROR);
+
+bool Buzzer::setup() {
+    bool ready = _synth.begin(_config.buzzer_pin);
+    configure();
+    return ready;
+} // setup
+
+void Buzzer::configure() {
+    _synth.setVolume(_config.volume);
+    _success_ms = _config.success_tone_ms;
+} // configure
 
 void Buzzer::toneStart(simon::note_t note, unsigned long duration) {
-    _tone(note, duration);
+    _synth.tone(note, duration, SoundFeedback);
 } // toneStart
 
-void Buzzer::stop() { noTone(_pin); } // stop
+void Buzzer::stop() { _synth.stop(SoundFeedback); } // stop
 
-void Buzzer::playErrorSound() { _tone(NOTE_A2, ERROR_TONE_DURATION); } // error
+void Buzzer::playErrorSound() { _synth.play(ERROR_SOUND, SoundAlert); } // error
 
 void Buzzer::success() {
-    singleTone(NOTE_E5, SUCCESS_TONE_DURATION);
-    singleTone(NOTE_G5, SUCCESS_TONE_DURATION);
-    singleTone(NOTE_E6, SUCCESS_TONE_DURATION);
-    singleTone(NOTE_D6, SUCCESS_TONE_DURATION);
-    singleTone(NOTE_G6, SUCCESS_TONE_DURATION);
+    static_assert(sizeof(SUCCESS_STEPS) / sizeof(SUCCESS_STEPS[0]) == SUCCESS_STEPS_COUNT,
+                  "SUCCESS_STEPS_COUNT does not match SUCCESS_STEPS");
+
+    // The tone duration is tunable at runtime. The synth timer may still be reading
+    // the previous success sound, stop it before its steps are rewritten
+    _synth.stop(SoundFeedback);
+    for (uint8_t i = 0; i < SUCCESS_STEPS_COUNT; i++) {
+        _success_steps[i]       = SUCCESS_STEPS[i];
+        _success_steps[i].on_ms = _success_ms;
+    }
+    _synth.play({_success_steps, SUCCESS_SOUND.count, SUCCESS_SOUND.envelope}, SoundFeedback);
 } // success
 
-void Buzzer::singleTone(uint16_t note, uint16_t duration) {
-    toneStart(note);
-    delay(duration);
-    stop();
-} // singleTone
-
-void Buzzer::playRoundWinSound() {
-    uint16_t duration = 60;
-    uint16_t pause    = 20;
-
-    singleTone(NOTE_C5, duration);
-    delay(pause);
-    singleTone(NOTE_E5, duration);
-    delay(pause);
-    singleTone(NOTE_G5, duration);
-    delay(pause);
-    singleTone(NOTE_C5, duration);
-    delay(pause);
-    singleTone(NOTE_E5, duration);
-    delay(pause);
-    singleTone(NOTE_G5, duration);
-    delay(pause);
-    singleTone(NOTE_C6, duration);
-} // win
-
-void Buzzer::playInitialSound() {
-    uint16_t duration = 80;
-    uint16_t pause    = 30;
-
-    singleTone(NOTE_C5, duration);
-    delay(pause);
-    singleTone(NOTE_E5, duration);
-    delay(pause);
-    singleTone(NOTE_G5, duration);
-    delay(pause);
-    singleTone(NOTE_C5, duration);
-    delay(pause);
-    singleTone(NOTE_E5, duration);
-    delay(pause);
-    singleTone(NOTE_G5, duration);
-    delay(pause);
-    singleTone(NOTE_C6, duration);
-} // playInitialSound
+void Buzzer::playRoundWinSound() { _synth.play(ROUND_WIN_SOUND, SoundFeedback); } // win
+
+void Buzzer::playInitialSound() { _synth.play(INITIAL_SOUND, SoundFeedback); } // playInitialSound
 
 void Buzzer::playNewHighScoreSound() {
-    play_melody(_pin); // Play the Pacman melody
+    playMelody(MelodyPacman); // Play the Pacman melody
 } // playNewHighScoreSound
 
-void Buzzer::playCountdownSound() { singleTone(NOTE_C5, 100); } // playCountdownSound
+void Buzzer::playMelody(melody_id_t id) { _synth.play(melody(id), SoundMelody); } // playMelody
+
+void Buzzer::playCountdownSound() { toneStart(NOTE_C5, 100); } // playCountdownSound
 
-} // namespace simon
\ No newline at end of file
+} // namespace simon
@@ -0,0 +1,84 @@
+#include "console.h"
+
+using namespace simon;
+
+bool Console::addCommand(const char* name, const char* help, CommandFunction run) {
+    if (_commands_count >= CONSOLE_MAX_COMMANDS) {
+        _stream.println(F("Error: too many console commands!"));
+        return false;
+    }
+
+    _commands[_commands_count++] = {name, help, run};
+    return true;
+}
+
+void Console::poll() {
+    // Bounded amount of work per loop, the rest stays in the FIFO
+    for (uint8_t n = 0; n < CONSOLE_POLL_BYTES && _stream.available() > 0; n++) {
+        char c = _stream.read();
+
+        if (c == '\n' || c == '\r') {
+            if (_overflow) {
+                _stream.println(F("Error: line too long"));
+            } else if (_length > 0) {
+                _line[_length] = '\0';
+                execute();
+            }
+            _length   = 0;
+            _overflow = false;
+        } else if (_length < CONSOLE_LINE_LENGTH - 1) {
+            _line[_length++] = c;
+        } else {
+            _overflow = true;
+        }
+    }
+}
+
+void Console::execute() {
+    // Split the line in place
+    char* argv[CONSOLE_MAX_ARGS];
+    uint8_t argc = 0;
+
+    char* p = _line;
+    while (*p != '\0' && argc < CONSOLE_MAX_ARGS) {
+        while (*p == ' ' || *p == '\t') {
+            *p++ = '\0';
+        }
+        if (*p == '\0') {
+            break;
+        }
+        argv[argc++] = p;
+        while (*p != '\0' && *p != ' ' && *p != '\t') {
+            p++;
+        }
+    }
+
+    if (argc == 0) {
+        return;
+    }
+
+    if (strcmp(argv[0], "help") == 0) {
+        printHelp();
+        return;
+    }
+
+    for (uint8_t i = 0; i < _commands_count; i++) {
+        if (strcmp(argv[0], _commands[i].name) == 0) {
+            _commands[i].run(argc, argv);
+            return;
+        }
+    }
+
+    _stream.print(F("Unknown command: "));
+    _stream.println(argv[0]);
+}
+
+void Console::printHelp() {
+    _stream.println(F("help: this list"));
+
+    for (uint8_t i = 0; i < _commands_count; i++) {
+        _stream.print(_commands[i].name);
+        _stream.print(F(": "));
+        _stream.println(_commands[i].help);
+    }
+}
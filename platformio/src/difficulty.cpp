@@ -0,0 +1,55 @@
+#include "difficulty.h"
+
+using namespace simon;
+
+void Difficulty::reset() {
+    _progress = 0;
+    update(1, LatencyStats());
+}
+
+uint16_t Difficulty::curveProgress(uint16_t round) {
+    uint16_t elapsed = round > 0 ? round - 1 : 0;
+
+#if DIFFICULTY_CURVE == DIFFICULTY_CURVE_STEPS
+    elapsed -= elapsed % DIFFICULTY_STEP_ROUNDS;
+#endif
+
+    if (elapsed >= DIFFICULTY_RAMP_ROUNDS) {
+        return 256;
+    }
+
+    uint32_t linear = (static_cast<uint32_t>(elapsed) * 256) / DIFFICULTY_RAMP_ROUNDS;
+
+#if DIFFICULTY_CURVE == DIFFICULTY_CURVE_EASE_OUT
+    // 1 - (1 - x)^2
+    uint32_t remaining = 256 - linear;
+    return 256 - (remaining * remaining) / 256;
+#else
+    return linear;
+#endif
+}
+
+uint16_t Difficulty::interpolate(uint16_t from, uint16_t to, uint16_t progress) {
+    // from and to are durations with from >= to
+    return from - (static_cast<uint32_t>(from - to) * progress) / 256;
+}
+
+void Difficulty::update(uint16_t round, const LatencyStats& stats) {
+    int32_t progress = curveProgress(round);
+
+    // Fast players get a faster playback, slow players get some room
+    if (stats.count() >= DIFFICULTY_MIN_SAMPLES) {
+        uint32_t median = stats.medianMs();
+        if (median < DIFFICULTY_FAST_REACTION_MS) {
+            progress += DIFFICULTY_REACTION_SHIFT;
+        } else if (median > DIFFICULTY_SLOW_REACTION_MS) {
+            progress -= DIFFICULTY_REACTION_SHIFT;
+        }
+    }
+
+    _progress       = constrain(progress, static_cast<int32_t>(0), static_cast<int32_t>(256));
+
+    _timing.on_ms   = interpolate(SEQUENCE_STEP_ON_MAX, SEQUENCE_STEP_ON_MIN, _progress);
+    _timing.off_ms  = interpolate(SEQUENCE_STEP_OFF_MAX, SEQUENCE_STEP_OFF_MIN, _progress);
+    _timing.tone_ms = (static_cast<uint32_t>(_timing.on_ms) * SEQUENCE_TONE_PERCENT) / 100;
+}
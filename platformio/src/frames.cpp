@@ -0,0 +1,125 @@
+#include "frames.h"
+
+using namespace simon;
+
+void FramePipeline::transferTask(void* arg) {
+    FramePipeline* pipeline = static_cast<FramePipeline*>(arg);
+
+    for (;;) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+        uint32_t start = micros();
+        pipeline->_oled.flushBuffer(
+            pipeline->_front, 0, SCREEN_HEIGHT / 8 - 1, 0, SCREEN_WIDTH - 1);
+        uint32_t elapsed = micros() - start;
+
+        pipeline->_transfer_total_us += elapsed;
+        if (elapsed > pipeline->_transfer_max_us) {
+            pipeline->_transfer_max_us = elapsed;
+        }
+
+        xSemaphoreGive(pipeline->_idle);
+    }
+}
+
+bool FramePipeline::begin(uint8_t fps) {
+    if (_task == nullptr) {
+        _idle = xSemaphoreCreateBinary();
+        if (_idle == nullptr) {
+            Serial.println(F("Error: failed to create frame pipeline semaphore!"));
+            return false;
+        }
+        xSemaphoreGive(_idle);
+
+        if (xTaskCreate(transferTask, "frames", FRAME_PIPELINE_STACK, this, 1, &_task) != pdPASS) {
+            Serial.println(F("Error: failed to create frame pipeline task!"));
+            vSemaphoreDelete(_idle);
+            _idle = nullptr;
+            _task = nullptr;
+            return false;
+        }
+    }
+
+    _frame_us          = 1000000UL / max<uint8_t>(fps, 1);
+    _deadline_us       = micros() + _frame_us;
+    _compose_start     = micros();
+    _frames            = 0;
+    _missed            = 0;
+    _compose_max_us    = 0;
+    _compose_total_us  = 0;
+    _stall_total_us    = 0;
+    _transfer_max_us   = 0;
+    _transfer_total_us = 0;
+    return true;
+}
+
+void FramePipeline::present(const uint8_t* back) {
+    uint32_t now     = micros();
+    uint32_t compose = now - _compose_start;
+    _compose_total_us += compose;
+    if (compose > _compose_max_us) {
+        _compose_max_us = compose;
+    }
+
+    if (_task == nullptr || back == nullptr) {
+        return;
+    }
+
+    // Wait for the previous frame to leave the front buffer
+    xSemaphoreTake(_idle, portMAX_DELAY);
+    _stall_total_us += micros() - now;
+
+    memcpy(_front, back, sizeof(_front));
+    xTaskNotifyGive(_task);
+    _frames++;
+}
+
+bool FramePipeline::frameDue() {
+    uint32_t now = micros();
+    int32_t late = static_cast<int32_t>(now - _deadline_us);
+    if (late < 0) {
+        return false;
+    }
+
+    if (late >= static_cast<int32_t>(_frame_us)) {
+        // Overran the slot: skip ahead instead of trying to catch up
+        _missed++;
+        _deadline_us = now + _frame_us;
+    } else {
+        _deadline_us += _frame_us;
+    }
+    return true;
+}
+
+void FramePipeline::finish() {
+    if (_task == nullptr) {
+        return;
+    }
+
+    xSemaphoreTake(_idle, portMAX_DELAY);
+    xSemaphoreGive(_idle);
+}
+
+void FramePipeline::printStats() const {
+    if (_frames == 0) {
+        return;
+    }
+
+    Serial.print(F("Frames: "));
+    Serial.print(_frames);
+    Serial.print(F(" @ "));
+    Serial.print(1000000UL / _frame_us);
+    Serial.print(F(" fps, missed "));
+    Serial.print(_missed);
+    Serial.print(F(", compose avg "));
+    Serial.print(_compose_total_us / _frames);
+    Serial.print(F(" us max "));
+    Serial.print(_compose_max_us);
+    Serial.print(F(", transfer avg "));
+    Serial.print(_transfer_total_us / _frames);
+    Serial.print(F(" us max "));
+    Serial.print(_transfer_max_us);
+    Serial.print(F(", stall avg "));
+    Serial.print(_stall_total_us / _frames);
+    Serial.println(F(" us"));
+}
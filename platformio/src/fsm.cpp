@@ -3,7 +3,9 @@
 simon::Fsm::CallbackEnterFunction enter_cb;
 simon::Fsm::CallbackExitFunction exit_cb;
 
-String simon::Fsm::stateTypeToString(simon::Fsm::StateType type) {
+static simon::Fsm::StateType current_state = simon::Fsm::StateType::INITIAL_STATE;
+
+const __FlashStringHelper* simon::Fsm::stateTypeToString(simon::Fsm::StateType type) {
     switch (type) {
     case simon::Fsm::StateType::INITIAL_STATE:          return F("InitialState");
     case simon::Fsm::StateType::GAME_START_STATE:       return F("GameStartState");
@@ -15,8 +17,9 @@ String simon::Fsm::stateTypeToString(simon::Fsm::StateType type) {
     }
 }
 
-String simon::Fsm::eventTypeToString(simon::Fsm::EventType type) {
+const __FlashStringHelper* simon::Fsm::eventTypeToString(simon::Fsm::EventType type) {
     switch (type) {
+    case simon::Fsm::EventType::INITIAL_STATE_EVENT:    return F("InitialState");
     case simon::Fsm::EventType::GAME_START_EVENT:       return F("GameStart");
     case simon::Fsm::EventType::PLAYING_SEQUENCE_EVENT: return F("PlayingSequence");
     case simon::Fsm::EventType::PLAYING_USER_EVENT:     return F("PlayingUser");
@@ -30,106 +33,39 @@ void simon::Fsm::setEnterCallback(CallbackEnterFunction cb) { enter_cb = cb; }
 
 void simon::Fsm::setExitCallback(CallbackExitFunction cb) { exit_cb = cb; }
 
-void simon::Fsm::dispatchStateEnter(Switch& state) {
-    if (enter_cb) {
-        enter_cb(state.getType());
-    }
-}
-
-void simon::Fsm::dispatchStateExit(Switch& state) {
-    if (exit_cb) {
-        exit_cb(state.getType());
-    }
-}
-
-void simon::Fsm::Switch::entry() {
-    dispatchStateEnter(*this); // Dispatch the enter callback
-}
-
-void simon::Fsm::Switch::exit() {
-    dispatchStateExit(*this); // Dispatch the exit callback
-}
-
-void simon::Fsm::Switch::reset() {
+void simon::Fsm::reset() {
     Serial.println(F("Resetting Game State Machine"));
-    // Reset the state machine to the initial state
-    ::tinyfsm::StateList<InitialState,
-                         GameStartState,
-                         PlayingSequenceState,
-                         PlayingUserState,
-                         PlayingWinState,
-                         PlayingLoseState>::reset();
-}
-
-simon::Fsm::Switch& simon::Fsm::Switch::currentState() {
-    // Return the current state of the FSM
-    return *current_state_ptr;
+    current_state = simon::Fsm::StateType::INITIAL_STATE;
 }
 
-void simon::Fsm::InitialState::react(simon::Fsm::Event const& event) {
-    Serial.print(F("InitialState: Reacting to event: "));
-    Serial.println(simon::Fsm::eventTypeToString(event.type));
-
-    if (event.type == simon::Fsm::EventType::GAME_START_EVENT) {
-        transit<simon::Fsm::GameStartState>();
-    } else {
-        Serial.println(F("Unhandled event in Initial State"));
+void simon::Fsm::start() {
+    if (enter_cb) {
+        enter_cb(current_state);
     }
 }
 
-void simon::Fsm::GameStartState::react(simon::Fsm::Event const& event) {
-    Serial.print(F("GameStartState: Reacting to event: "));
-    Serial.println(simon::Fsm::eventTypeToString(event.type));
+simon::Fsm::StateType simon::Fsm::currentState() { return current_state; }
 
-    if (event.type == simon::Fsm::EventType::PLAYING_SEQUENCE_EVENT) {
-        transit<simon::Fsm::PlayingSequenceState>();
-    } else {
-        Serial.println(F("Unhandled event in Game Start State"));
-    }
-}
-
-void simon::Fsm::PlayingSequenceState::react(simon::Fsm::Event const& event) {
-    Serial.print(F("PlayingSequenceState: Reacting to event: "));
-    Serial.println(simon::Fsm::eventTypeToString(event.type));
+bool simon::Fsm::dispatch(simon::Fsm::EventType event) {
+    Serial.print(simon::Fsm::stateTypeToString(current_state));
+    Serial.print(F(": Reacting to event: "));
+    Serial.println(simon::Fsm::eventTypeToString(event));
 
-    if (event.type == simon::Fsm::EventType::PLAYING_USER_EVENT) {
-        transit<simon::Fsm::PlayingUserState>();
-    } else {
-        Serial.println(F("Unhandled event in Playing Sequence State"));
+    uint8_t next = event < EVENT_TYPES_COUNT ? TRANSITION_TABLE.next[current_state][event]
+                                             : NO_TRANSITION;
+    if (next == NO_TRANSITION) {
+        Serial.println(F("Unhandled event"));
+        return false;
     }
-}
 
-void simon::Fsm::PlayingUserState::react(simon::Fsm::Event const& event) {
-    Serial.print(F("PlayingUserState: Reacting to event: "));
-    Serial.println(simon::Fsm::eventTypeToString(event.type));
-
-    if (event.type == simon::Fsm::EventType::PLAYING_WIN_EVENT) {
-        transit<simon::Fsm::PlayingWinState>();
-    } else if (event.type == simon::Fsm::EventType::PLAYING_LOSE_EVENT) {
-        transit<simon::Fsm::PlayingLoseState>();
-    } else {
-        Serial.println(F("Unhandled event in Playing User State"));
+    if (exit_cb) {
+        exit_cb(current_state);
     }
-}
 
-void simon::Fsm::PlayingWinState::react(simon::Fsm::Event const& event) {
-    Serial.print(F("PlayingWinState: Reacting to event: "));
-    Serial.println(simon::Fsm::eventTypeToString(event.type));
+    current_state = static_cast<simon::Fsm::StateType>(next);
 
-    if (event.type == simon::Fsm::EventType::PLAYING_SEQUENCE_EVENT) {
-        transit<simon::Fsm::PlayingSequenceState>();
-    } else {
-        Serial.println(F("Unhandled event in Playing Win State"));
+    if (enter_cb) {
+        enter_cb(current_state);
     }
+    return true;
 }
-
-void simon::Fsm::PlayingLoseState::react(simon::Fsm::Event const& event) {
-    Serial.print(F("PlayingLoseState: Reacting to event: "));
-    Serial.println(simon::Fsm::eventTypeToString(event.type));
-
-    if (event.type == simon::Fsm::EventType::INITIAL_STATE_EVENT) {
-        transit<simon::Fsm::InitialState>();
-    } else {
-        Serial.println(F("Unhandled event in Playing Lose State"));
-    }
-}
\ No newline at end of file
@@ -12,7 +12,6 @@
 #include "fsm.h"
 #include "game.h"
 #include "tones.h"
-#include <vector>
 
 // PROGMEM strings for display
 const char PROGMEM STR_SIMON[]          = "Simon";
@@ -45,8 +44,20 @@ const char PROGMEM STR_RESET_RECORD[]   = "Resetto";
 const char PROGMEM STR_RECORD_RESET[]   = "Record...";
 const char PROGMEM STR_RECORD_CLEARED[] = "Record";
 const char PROGMEM STR_CLEARED[]        = "Cancellato!";
-
-FSM_INITIAL_STATE(simon::Fsm::Switch, simon::Fsm::InitialState)
+const char PROGMEM STR_REACTION[]       = "Reazione";
+const char PROGMEM STR_LATENCY_MIN[]    = "min ";
+const char PROGMEM STR_LATENCY_MEDIAN[] = "med ";
+const char PROGMEM STR_LATENCY_P95[]    = "p95 ";
+const char PROGMEM STR_MS[]             = "ms";
+const char PROGMEM STR_PLAYER[]         = "Giocatore ";
+const char PROGMEM STR_TURN[]           = "Turno ";
+const char PROGMEM STR_EMPTY[]          = "";
+const char PROGMEM STR_WINNER[]         = "Vince il";
+const char PROGMEM STR_TIE[]            = "Pareggio!";
+
+// PROGMEM sprites for display (SSD1306 page layout)
+// Blinking arrow shown next to the start hint (4x8, two frames)
+const uint8_t PROGMEM IDLE_ARROW_FRAMES[] = {0x7F, 0x3E, 0x1C, 0x08, 0x00, 0x00, 0x00, 0x00};
 
 namespace simon {
 
@@ -59,33 +70,48 @@ Adafruit_NeoPixel strip(LED_COUNT, LED_PIN, NEO_GRB + NEO_KHZ800);
 
 Preferences _preferences; // Preferences object for storing game state
 
-using fsm_handle = simon::Fsm::Switch;
+// Sequence of colors for the game
+Sequence sequence;
 
-// Global variables for game state
-unsigned long state_start_time = 0;
+// Progress of each player in the current game
+typedef struct PlayerState {
+    uint8_t button_index;       // Current index in the sequence
+    uint8_t score;              // Sequence length reached when the player went out
+    bool active;                // Still answering in the current round
+    bool passed;                // Completed the current round
+    bool out;                   // Made a mistake, out of the game
+} player_state_t;
 
-// Sequence of colors for the game
-std::vector<color_t> sequence;
-// Current index in the sequence
-size_t button_index = 0;
-// Timer for button press duration
-unsigned long button_timer = 0;
+player_state_t players[MAX_PLAYERS];
 
 Game::Game() :
-    _leds(simon::Leds(strip)) // Initialize the LED controller with the NeoPixel strip
+    _config(Settings::defaults()) // config.h values until the saved settings are loaded
+    ,
+    _leds(strip, _config) // Initialize the LED controller with the NeoPixel strip
     ,
-    _buttons() // Initialize the button controller with individual pins
+    _buttons(_config) // Initialize the button controller with the configured pins
     ,
-    _buzzer(BUZZER_PIN) // Initialize the buzzer controller with the defined pin
+    _buzzer(_config) // Initialize the buzzer controller with the configured pin
     ,
     _display(Adafruit_SSD1306(SCREEN_WIDTH,
                               SCREEN_HEIGHT,
                               &Wire,
-                              OLED_RESET)) // Initialize the display controller
+                              OLED_RESET,
+                              OLED_I2C_CLOCK,
+                              OLED_I2C_CLOCK)) // Initialize the display controller
+    ,
+    _oled(_display, Wire, SCREEN_ADDRESS) // Partial updates for the display
     ,
     _board(Board()) // Initialize the board controller
+    ,
+    _frames(_oled) // Animation frames go through the partial update helper
+    ,
+    _console(Serial) // Commands come from the debug serial port
 {
-    // Constructor implementation
+    // Classic rules until the saved mode is loaded. Not through selectMode(): the
+    // game is constructed before Serial is started
+    _mode_index = 0;
+    _mode       = &gameMode(0);
 }
 
 void Game::displayWelcomeMessage() {
@@ -93,28 +119,58 @@ void Game::displayWelcomeMessage() {
     _display.setTextSize(2);
     _display.setCursor(0, 0); // Start at top-left corner
     _display.setTextColor(SSD1306_WHITE);
-    _display.display();
 
-    // draw the text centered horizontally on the display
+    // draw the text centered horizontally on the display (the caller sends it)
+    _text.drawCentered(_display, STR_SIMON, 0);
+    _text.drawCentered(_display, STR_AMPERSAND, 2);
+    _text.drawCentered(_display, STR_SIMON, 4);
+}
 
-    int16_t x1, y1;
-    uint16_t w, h;
+void Game::bootProgress(const __FlashStringHelper* message, uint16_t pause_ms) {
+#if FAST_BOOT
+    // The welcome message is already on screen
+    (void)message;
+    (void)pause_ms;
+#else
+    _display.println(message);
+    _oled.flush();
+    delay(pause_ms);
+#endif
+}
 
-    _display.getTextBounds(FPSTR(STR_SIMON), 0, 0, &x1, &y1, &w, &h);
-    _display.setCursor((SCREEN_WIDTH - w) / 2, 0); // Center text
-    _display.println(FPSTR(STR_SIMON));
+void Game::cacheTexts() {
+    // Strings drawn over and over are rendered once here
+    static const char* const texts[] = {STR_SIMON,
+                                        STR_AMPERSAND,
+                                        STR_PRESS_BUTTON,
+                                        STR_BUTTON_TO,
+                                        STR_START,
+                                        STR_RECORD,
+                                        STR_CURRENT,
+                                        STR_PRESS_THE,
+                                        STR_RIGHT_BUTTON};
+
+    for (const char* text : texts) {
+        _text.add(text);
+    }
 
-    _display.getTextBounds(FPSTR(STR_AMPERSAND), 0, 0, &x1, &y1, &w, &h);
-    _display.setCursor((SCREEN_WIDTH - w) / 2, 16); // Center text
-    _display.println(FPSTR(STR_AMPERSAND));
+    for (uint8_t i = 0; i < COLORS_COUNT; i++) {
+        _text.add(colorToName(static_cast<color_t>(i)));
+    }
+
+    for (uint8_t i = 0; i < GAME_MODES_COUNT; i++) {
+        _text.add(gameMode(i).name());
+    }
 
-    _display.getTextBounds(FPSTR(STR_SIMON), 0, 0, &x1, &y1, &w, &h);
-    _display.setCursor((SCREEN_WIDTH - w) / 2, 32); // Center text
-    _display.println(FPSTR(STR_SIMON));
-    _display.display();
+    Serial.print(F("Text cache: "));
+    Serial.print(_text.bytesUsed());
+    Serial.println(F(" bytes"));
 }
 
 bool Game::setup() {
+    // Dumps where the loop was stuck if the watchdog reset the board
+    Supervisor::begin();
+
     // SSD1306_SWITCHCAPVCC = generate display voltage from 3.3V internally
     Serial.println(F("Init board.."));
     _board.setup();
@@ -123,99 +179,193 @@ bool Game::setup() {
     _board.turn_off_builtin_led();
     _board.turn_off_rgb_leds(); // Turn off RGB LEDs
 
+    registerMemory();
+    registerConsole();
+
+    // Saved settings, before any subsystem reads them
+    if (!Settings::load(_config)) {
+        Serial.println(F("No saved settings, using the defaults"));
+    }
+
     Serial.print(F("Init SSD1306 display..."));
-    if (!_display.begin(SSD1306_SWITCHCAPVCC, SCREEN_ADDRESS)) {
+    bool displayReady;
+    {
+        Memory::Scope memory(Memory::ModuleDisplay); // begin() allocates the framebuffer
+        displayReady = _display.begin(SSD1306_SWITCHCAPVCC, SCREEN_ADDRESS);
+    }
+
+    // begin() does not check that the controller answers
+    displayReady = displayReady && Health::probeI2C(Wire, SCREEN_ADDRESS);
+    _health.set(CapDisplay, displayReady);
+    _oled.setPresent(_health.has(CapDisplay)); // No I2C traffic at all without a display
+
+    if (!displayReady) {
         Serial.println(F("failed!"));
-        _board.set_rgb_led_color(true, false, false);
 
-        // Try to continue without display but indicate error
+        // Continue without display, the RGB LED stays red to indicate the error
+        _board.set_rgb_led_color(true, false, false);
         Serial.println(F("Warning: Continuing without display functionality"));
-        delay(2000);
-        _board.turn_off_rgb_leds();
     } else {
+        _oled.begin();
         Serial.println(F("done."));
     }
 
+#if FAST_BOOT
+    // The welcome message is sent by the frame pipeline task while the rest is initialized
+    {
+        Memory::Scope memory(Memory::ModuleDisplay);
+        cacheTexts();
+        _frames.begin();
+    }
+    displayWelcomeMessage();
+    _frames.present(_display.getBuffer());
+#else
     _display.clearDisplay();
     _display.setTextSize(1);              // Set text size to 1
     _display.setTextColor(SSD1306_WHITE); // Set text color to white
     _display.setCursor(0, 0);             // Set cursor to top-left corner
-    _display.display();
+    _oled.flush();
     delay(100);
+#endif
 
-    _display.println(F("Init Preferences.."));
-    _display.display();
-    if (!_preferences.begin("simon", false)) {
-        _display.println(F("error!"));
+    bootProgress(F("Init Preferences.."));
+    bool preferencesReady;
+    {
+        Memory::Scope memory(Memory::ModuleGame);
+        preferencesReady = _preferences.begin("simon", false);
+    }
+    _health.set(CapStorage, preferencesReady);
+    if (!preferencesReady) {
         Serial.println(
             F("Warning: Preferences initialization failed, high score will not persist"));
         _high_score = 0; // Use default value
-        delay(1000);
+        selectMode(0);
+        bootProgress(F("error!"), 500);
     } else {
         _high_score = _preferences.getUInt("high_score", 0);
-        _display.println(F("ok"));
+        selectMode(_preferences.getUChar("mode", 0));
+        bootProgress(F("ok"), 500);
     }
-    _display.display();
 
-    delay(500);
-
-    _display.println(F("Init leds.."));
-    _display.display();
-    _leds.setup();
-
-    _display.println(F("ok"));
-    _display.display();
-
-    delay(500);
+    bootProgress(F("Init leds.."));
+    bool layout_ok;
+    {
+        Memory::Scope memory(Memory::ModuleLeds);
+        layout_ok = _leds.setup();
+    }
 
-    _display.println(F("Init buttons.."));
-    _display.display();
+    // WS2812 pixels have no readback, only the pixel buffer and the layout can be checked
+    _health.set(CapLeds, strip.numPixels() == _config.led_count && layout_ok);
+    _leds.setPresent(_health.has(CapLeds)); // Nothing sent to a strip that failed
+    bootProgress(F("ok"), 500);
 
-    _buttons.setup();
+    bootProgress(F("Init buttons.."));
 
-    _display.println(F("ok"));
-    _display.display();
-    delay(500);
+    {
+        Memory::Scope memory(Memory::ModuleButtons);
+        _buttons.setup();
+    }
+    _health.setStuckButtons(_buttons.selfTest());
 
-    _display.println(F("Init buzzer.."));
-    _display.display();
+    // Any button wakes the game up from light sleep
+    _power.begin();
+    for (uint8_t bank = 0; bank < _buttons.getBanksCount(); bank++) {
+        for (uint8_t i = 0; i < COLORS_COUNT; i++) {
+            _power.addWakePin(_buttons.getButton(bank, i).getPin());
+        }
+    }
+    _power.addWakePin(_config.reset_button_pin);
+    bootProgress(F("ok"), 500);
 
-    _buzzer.setup();
+    bootProgress(F("Init buzzer.."));
+    {
+        Memory::Scope memory(Memory::ModuleBuzzer); // Synth timer
+        _health.set(CapBuzzer, _buzzer.setup());
+    }
+    bootProgress(F("ok"), 500);
 
-    _display.println(F("ok"));
-    _display.display();
-    delay(500);
+#if FAST_BOOT
+    _frames.finish(); // The main loop owns the bus from now on
 
+    // The splash plays from the idle loop, a button press cuts it short
+    _buzzer.playInitialSound();
+    _splash          = true;
+    _splash_start_ms = millis();
+    _splash_frame    = -1;
+#else
     // Display welcome message
+    {
+        Memory::Scope memory(Memory::ModuleDisplay);
+        cacheTexts();
+    }
     displayWelcomeMessage();
+    _oled.flush();
 
     _buzzer.playInitialSound();
 
-    _leds.rainbow();
+    _leds.rainbow(1500);
     _leds.clearNow();
 
-    _leds.wipe(strip.Color(255, 0, 0), simon::WipeFromStart, 50, 0, 6);    // Red
-    _leds.wipe(strip.Color(0, 255, 0), simon::WipeFromStart, 50, 6, 6);    // Green
-    _leds.wipe(strip.Color(0, 0, 255), simon::WipeFromStart, 50, 12, 6);   // Blue
-    _leds.wipe(strip.Color(255, 255, 0), simon::WipeFromStart, 50, 18, 6); // Yellow
+    _leds.wipe(strip.Color(255, 0, 0), simon::WipeFromStart, 0);   // Red
+    _leds.wipe(strip.Color(0, 255, 0), simon::WipeFromStart, 1);   // Green
+    _leds.wipe(strip.Color(0, 0, 255), simon::WipeFromStart, 2);   // Blue
+    _leds.wipe(strip.Color(255, 255, 0), simon::WipeFromStart, 3); // Yellow
 
     delay(1000); // Show the welcome message for 2 seconds
 
     _leds.clearNow();
     _display.clearDisplay();
-    _display.display();
+    _oled.flush();
+#endif
 
     // Adding callbacks for button events
-    _buttons.setPressedCallback([this](Button& btn) { this->onButtonPressed(btn); });
-    _buttons.setReleasedCallback([this](Button& btn) { this->onButtonReleased(btn); });
+    _buttons.setPressedCallback(
+        Buttons::CallbackFunction::bind<Game, &Game::onButtonPressed>(this));
+    _buttons.setReleasedCallback(
+        Buttons::CallbackFunction::bind<Game, &Game::onButtonReleased>(this));
 
     // Set the initial state of the FSM
-    simon::Fsm::setEnterCallback([this](Fsm::StateType const& type) { this->onStateEnter(type); });
-    simon::Fsm::setExitCallback([this](Fsm::StateType const& type) { this->onStateExit(type); });
+    simon::Fsm::setEnterCallback(
+        Fsm::CallbackEnterFunction::bind<Game, &Game::onStateEnter>(this));
+    simon::Fsm::setExitCallback(Fsm::CallbackExitFunction::bind<Game, &Game::onStateExit>(this));
+
+    // State timeouts, the initial state arms its timers as soon as the FSM starts
+    _timers.begin(millis());
+    _timers.setExpiredCallback(
+        TimerWheel::CallbackFunction::bind<Game, &Game::onTimerExpired>(this));
+
+    // Read before the initial state, which keeps it while resuming
+    game_snapshot_t snapshot;
+    Sequence saved;
+    bool resume = Snapshot::restore(snapshot, saved);
+    _resuming   = resume;
+
+    {
+        Memory::Scope memory(Memory::ModuleFsm);
+        Fsm::reset();
+        Fsm::start();
+    }
+
+    // Input is accepted from here on
+    uint32_t boot_ms = millis();
+    Serial.print(F("Boot: ready for input after "));
+    Serial.print(boot_ms);
+    Serial.print(F(" ms (target "));
+    Serial.print(BOOT_TARGET_MS);
+    Serial.println(F(" ms)"));
+    if (boot_ms > BOOT_TARGET_MS) {
+        Serial.println(F("Warning: boot target missed"));
+    }
 
-    fsm_handle::reset();
-    fsm_handle::start();
+    _health.printReport();
+    Memory::printReport();
 
+    // The loop is supervised from here on, the boot may block longer
+    Supervisor::startWatchdog();
+
+    if (resume) {
+        resumeGame(snapshot, saved);
+    }
     return true;
 }
 
@@ -224,7 +374,9 @@ void Game::onStateEnter(Fsm::StateType const& type) {
     Serial.print(Fsm::stateTypeToString(type));
     Serial.println(F("'"));
 
-    state_start_time = millis(); // Record the time when the state is entered
+    // The game states must run without touching the heap
+    Memory::setState(type, type >= Fsm::StateType::PLAYING_SEQUENCE_STATE);
+    Supervisor::setState(type);
 
     switch (type) {
     case Fsm::StateType::INITIAL_STATE:          onEnterInitialState(); break;
@@ -247,74 +399,222 @@ void Game::onStateExit(Fsm::StateType const& type) {
     Serial.print(F("<== Exiting State: '"));
     Serial.print(Fsm::stateTypeToString(type));
     Serial.println(F("'"));
+
+    _timers.cancelState(type); // Timeouts and sequence steps never outlive their state
+
+    // Nor do the animations played from the loop
+    _rainbow = false;
+    if (_celebrating) {
+        stopCelebration();
+    }
 }
 
 void Game::onButtonPressed(Button& btn) {
-    auto currentState = fsm_handle::currentState();
+    Fsm::StateType currentState = Fsm::currentState();
 
-    Serial.print(Fsm::stateTypeToString(currentState.getType()));
+    Serial.print(Fsm::stateTypeToString(currentState));
     Serial.print(F(" | Button pressed: "));
     Serial.println(btn.getName());
 
+    if (currentState == Fsm::StateType::INITIAL_STATE) {
+        if (_splash) {
+            endSplash();
+        }
+        if (_power.state() != PowerAwake) {
+            wakeUp();
+        }
+        armPowerTimers();
+    }
+    if (_waking) {
+        return; // Only wakes the game up
+    }
+
     // Play sound and display color for feedback in all states
     simon::color_t pressedColor = btn.getType();
     _buzzer.toneStart(colorToNote(pressedColor), 0); // Play the corresponding note
-    _leds.showColor(pressedColor, 0);                // Show the color of the pressed button
+    _leds.showColor(pressedColor);                   // Show the color of the pressed button
 
     // Only process game logic in PLAYING_USER_STATE
-    if (currentState.getType() != Fsm::StateType::PLAYING_USER_STATE) {
+    if (currentState != Fsm::StateType::PLAYING_USER_STATE) {
         return; // For other states, just provide feedback and return
     }
+
+    uint8_t player = playerForButton(btn);
+    if (players[player].active) {
+        _reaction[player].recordPress(btn.getPressedAt());
+    }
+}
+
+uint8_t Game::playerForButton(Button& btn) {
+    // In concurrent modes every bank belongs to a player, otherwise any bank
+    // answers for the player whose turn it is
+    return _mode->concurrent() ? btn.getBank() : _mode->currentPlayer();
+}
+
+void Game::finishPlayer(uint8_t player, bool passed) {
+    player_state_t& state = players[player];
+    state.active          = false;
+    state.passed          = passed;
+    _timers.cancel(TimerInputTimeout + player);
+
+    if (!passed) {
+        state.out   = true;
+        state.score = sequence.size();
+    }
+
+    _reaction[player].commit(_latency[player]);
+
+    // The round ends once every player has either completed it or failed
+    bool any_active = false;
+    bool any_passed = false;
+    for (uint8_t p = 0; p < _mode->players(); p++) {
+        any_active |= players[p].active;
+        any_passed |= players[p].passed;
+    }
+
+    if (any_active) {
+        return;
+    }
+
+    if (any_passed) {
+        Fsm::dispatchFrom<Fsm::PLAYING_USER_STATE, Fsm::PLAYING_WIN_EVENT>();
+    } else {
+        Fsm::dispatchFrom<Fsm::PLAYING_USER_STATE, Fsm::PLAYING_LOSE_EVENT>();
+    }
+}
+
+void Game::selectMode(uint8_t index) {
+    _mode_index = index % GAME_MODES_COUNT;
+    _mode       = &gameMode(_mode_index);
+
+    Serial.print(F("Game mode: "));
+    Serial.println(FPSTR(_mode->name()));
 }
 
 void Game::onButtonReleased(Button& btn) {
-    auto currentState = fsm_handle::currentState();
-    Serial.print(Fsm::stateTypeToString(currentState.getType()));
+    Fsm::StateType currentState = Fsm::currentState();
+    Serial.print(Fsm::stateTypeToString(currentState));
     Serial.print(F(" | Button released: "));
     Serial.println(btn.getName());
 
+    if (_waking) {
+        _waking = false;
+        return;
+    }
+
     simon::color_t releasedColor = btn.getType();
 
     // If we're in the INITIAL state, transition to the GAME_START state
-    if (currentState.getType() == Fsm::StateType::INITIAL_STATE) {
+    if (currentState == Fsm::StateType::INITIAL_STATE) {
         _buzzer.stop();   // Stop the buzzer sound
         _leds.clearNow(); // Clear the LEDs
-        delay(500);
-        fsm_handle::dispatch(Fsm::EventType::GAME_START_EVENT);
 
-    } else if (currentState.getType() == Fsm::StateType::PLAYING_USER_STATE) {
-        button_timer = millis(); // Reset the button timer when a button is pressed
-        _buzzer.stop();          // Stop the buzzer sound when the button is released
-        _leds.clearNow();        // Clear the LEDs when the button is released
+        // A long press selects the next game mode instead of starting
+        uint32_t held_us = btn.getReleasedAt() - btn.getPressedAt();
+        if (held_us >= _config.mode_select_hold_ms * 1000UL) {
+            selectMode(_mode_index + 1);
+            _preferences.putUChar("mode", _mode_index);
+
+            // Show the idle page with the new mode name right away
+            showIdlePage(0);
+            _timers.arm(
+                TimerIdlePage, _config.idle_page_ms, Fsm::INITIAL_STATE, _config.idle_page_ms);
+            return;
+        }
 
-        Serial.print(F("Button released: "));
-        Serial.println(btn.getName());
+        Fsm::dispatchFrom<Fsm::INITIAL_STATE, Fsm::GAME_START_EVENT>();
+
+    } else if (currentState == Fsm::StateType::PLAYING_USER_STATE) {
+        uint8_t player        = playerForButton(btn);
+        player_state_t& state = players[player];
+
+        // In versus mode the other players may still hold their buttons: only the
+        // released color goes off, and the tone once no button is held anymore
+        bool any_held   = false;
+        bool color_held = false;
+        for (uint8_t bank = 0; bank < _buttons.getBanksCount(); bank++) {
+            Button* held = _buttons.getPressedButton(bank);
+            if (held != nullptr) {
+                any_held = true;
+                color_held |= held->getType() == releasedColor;
+            }
+        }
+        if (!any_held) {
+            _buzzer.stop(); // Stop the buzzer sound when the button is released
+        }
+        if (!color_held) {
+            _leds.hideColor(releasedColor); // Remove the color of the button
+        }
+
+        if (!state.active) {
+            return; // This player already completed the round or is out
+        }
+
+        // Restart the player's timeout on every input
+        _timers.arm(TimerInputTimeout + player, _config.input_timeout_ms, Fsm::PLAYING_USER_STATE);
+        _reaction[player].recordRelease(btn.getReleasedAt());
+
+        Serial.print(F("Player: "));
+        Serial.println(player + 1);
 
         Serial.print(F("Button index: "));
-        Serial.println(button_index);
+        Serial.println(state.button_index);
 
         Serial.print(F("Sequence size: "));
         Serial.println(sequence.size());
 
         // Check if the correct button was released
-        if (releasedColor == sequence[button_index]) {
-            if (button_index == sequence.size() - 1) {
-                fsm_handle::dispatch(Fsm::EventType::PLAYING_WIN_EVENT);
+        if (_mode->checkInput(sequence, state.button_index, releasedColor)) {
+            if (state.button_index + 1 >= _input_length) {
+                finishPlayer(player, true);
                 return;
             }
-            button_index++; // Move to the next button in the sequence
-            delay(16);
+            state.button_index++; // Move to the next button in the sequence
         } else {
-            fsm_handle::dispatch(Fsm::EventType::PLAYING_LOSE_EVENT);
+            finishPlayer(player, false);
         }
     }
 }
 
 void Game::loop() {
-    _buttons.loop();
+    Supervisor::loopStart(Fsm::currentState());
+    {
+        Supervisor::Scope scope(Supervisor::ScopeConsole);
+        _console.poll();
+    }
+    {
+        Supervisor::Scope scope(Supervisor::ScopeButtons);
+        _buttons.loop();
+    }
+    Memory::sample();
+    {
+        Supervisor::Scope scope(Supervisor::ScopeTimers);
+        _timers.poll(millis());
+    }
+
+    // One frame of the celebration, at most, per loop
+    if (_celebrating) {
+        Supervisor::Scope scope(Supervisor::ScopeCelebration);
+        celebrationFrame(millis());
+    }
 
-    auto currentState = fsm_handle::currentState();
-    onStateLoop(currentState.getType());
+    Fsm::StateType currentState = Fsm::currentState();
+    {
+        Supervisor::Scope scope(Supervisor::ScopeState);
+        onStateLoop(currentState);
+    }
+
+    // One composed LED frame per loop, whatever the state drew
+    if (_health.has(CapLeds)) {
+        Supervisor::Scope scope(Supervisor::ScopeLeds);
+        if (_rainbow) {
+            rainbowFrame(millis());
+        }
+        _leds.show();
+    }
+
+    // The only place the watchdog is fed
+    Supervisor::loopEnd();
 }
 
 void Game::onStateLoop(Fsm::StateType const& type) {
@@ -325,97 +625,343 @@ void Game::onStateLoop(Fsm::StateType const& type) {
         // Handle logic for the GAME_START state if needed
         break;
 
-    case Fsm::StateType::PLAYING_SEQUENCE_STATE:
-        // Handle logic for the PLAYING state
-        break;
-
-    case Fsm::StateType::PLAYING_USER_STATE:
-        // Handle logic for the PLAYING_USER state
-        onLoopPlayingUserState();
-        break;
+    case Fsm::StateType::PLAYING_SEQUENCE_STATE: onLoopPlayingSequenceState(); break;
 
     default: break;
     }
 }
 
 void Game::onLoopInitialState() {
-    unsigned long elapsedTime = (millis() - state_start_time) / 1000;
-    int switchTime            = 5;
+    if (_splash) {
+        // The welcome message stays on screen until the splash is over
+        if (!splashFrame(millis())) {
+            endSplash();
+        }
+        return;
+    }
 
-    // switch text every 5 seconds
-    if (elapsedTime % switchTime == 0) {
-        if (elapsedTime % (switchTime * 2) == 0) {
-            _display.clearDisplay();
-            _display.setCursor(0, 0);
-            _display.setTextSize(2);
-            _display.println();
+    if (_timers.isArmed(TimerStep)) {
+        return; // A sequence (celebration test, high score reset) owns the screen
+    }
 
-            _display.println(FPSTR(STR_PRESS_BUTTON));
-            _display.println(FPSTR(STR_BUTTON_TO));
-            _display.println(FPSTR(STR_START));
-        } else {
-            _display.clearDisplay();
-            _display.setCursor(0, 0);
-            _display.setTextSize(2);
-            _display.println(FPSTR(STR_RECORD));
-            _display.println(FPSTR(STR_CURRENT));
-            _display.println(_high_score);
+    if (_sleep_requested) {
+        _sleep_requested = false;
+        enterSleep();
+        return;
+    }
+
+    if (_power.state() == PowerDimmed) {
+        // Nothing moves on screen, poll the buttons at a slower pace
+        delay(POWER_IDLE_POLL_MS);
+        return;
+    }
+
+    // Only the widgets that changed are redrawn and sent to the display
+    _scene.render(_display, _oled, _text, millis());
+    _power.frameShown();
+}
+
+void Game::startRainbow(uint16_t duration_ms) {
+    // Played by the loop under the button feedback
+    _rainbow          = true;
+    _rainbow_start_ms = millis();
+    _rainbow_ms       = duration_ms;
+    _rainbow_frame    = -1;
+}
+
+void Game::rainbowFrame(uint32_t now_ms) {
+    uint32_t elapsed = now_ms - _rainbow_start_ms;
+    if (elapsed >= _rainbow_ms) {
+        _rainbow = false;
+        _leds.clear(LayerBackground);
+        return;
+    }
+
+    int32_t frame = elapsed / LED_FRAME_MS;
+    if (frame != _rainbow_frame) {
+        _rainbow_frame = frame;
+        _leds.rainbowFrame(Leds::rainbowHue(elapsed));
+    }
+}
+
+bool Game::splashFrame(uint32_t now_ms) {
+    uint32_t elapsed = now_ms - _splash_start_ms;
+    int32_t frame    = elapsed / SPLASH_FRAME_MS;
+    if (frame == _splash_frame) {
+        return true;
+    }
+    _splash_frame = frame;
+
+    if (elapsed < SPLASH_RAINBOW_MS) {
+        // Two turns of the color wheel
+        _leds.rainbowFrame((elapsed * 2 * 65536UL) / SPLASH_RAINBOW_MS);
+        return true;
+    }
+
+    elapsed -= SPLASH_RAINBOW_MS;
+    if (elapsed >= COLORS_COUNT * SPLASH_WIPE_MS + SPLASH_HOLD_MS) {
+        return false;
+    }
+
+    // One color wipe per segment of the layout, then hold
+    static const color_t colors[COLORS_COUNT] = {
+        color_t::ColorRed, color_t::ColorGreen, color_t::ColorBlue, color_t::ColorYellow};
+    uint32_t wipe = min<uint32_t>(elapsed / SPLASH_WIPE_MS, COLORS_COUNT);
+
+    _leds.clear();
+    for (uint8_t i = 0; i < COLORS_COUNT && i <= wipe; i++) {
+        // Fixed point wipe position, so the front pixel fades in between frames
+        uint32_t steps    = _leds.layout().segmentSize(i);
+        uint32_t position = steps << 8;
+        if (i == wipe) {
+            position = ((elapsed % SPLASH_WIPE_MS) * position) / SPLASH_WIPE_MS;
         }
-        _display.display();
+        _leds.wipeFrame(colorToRGB(colors[i]), WipeFromStart, i, position);
+    }
+    _leds.show();
+    return true;
+}
+
+void Game::endSplash() {
+    // The idle scene was reset when the state was entered, its first render
+    // replaces the welcome message
+    _splash = false;
+    _leds.clearNow();
+}
+
+void Game::showIdlePage(uint8_t page) {
+    _idle_layout = page;
+    _scene.reset();
+
+    if (page == 0) {
+        _scene.addText(_mode->name(), 0, 0);
+        _scene.addText(STR_PRESS_BUTTON, 0, 2);
+        _scene.addText(STR_BUTTON_TO, 0, 4);
+        _scene.addText(STR_START, 0, 6);
+        _scene.addAnimation(IDLE_ARROW_FRAMES, 2, 500, 4, 1, 120, 6);
+    } else {
+        _scene.addText(STR_RECORD, 0, 0);
+        _scene.addText(STR_CURRENT, 0, 2);
+        _scene.addNumber(_high_score, 0, 4);
     }
+}
+
+void Game::onTimerExpired(uint8_t id) {
+    switch (id) {
+    case TimerIdlePage:
+        // switch text every idle_page_ms
+        showIdlePage(_idle_layout == 0 ? 1 : 0);
+        break;
 
-    // Show rainbow effect every 15 seconds to indicate system is active
-    static unsigned long lastRainbowTime = 0;
-    const unsigned long rainbowInterval  = 15000; // 15 seconds
+    case TimerIdleRainbow:
+        // Show rainbow effect to indicate system is active, unless the LEDs are in use
+        if (!_splash && !_timers.isArmed(TimerStep)) {
+            startRainbow(IDLE_RAINBOW_DURATION_MS);
+        }
+        break;
 
-    if (millis() - lastRainbowTime > rainbowInterval) {
-        _leds.rainbow(2, 2); // Quick rainbow with 3ms delay, 1 cycle
+    case TimerPowerDim:
+        Serial.println(F("Idle, dimming..."));
+        _timers.cancel(TimerIdlePage);
+        _timers.cancel(TimerIdleRainbow);
+        _rainbow = false;
         _leds.clearNow();
-        lastRainbowTime = millis();
+        _oled.dim(true);
+        _power.dim();
+        break;
+
+    case TimerPowerSleep:
+        // Not from here: the timer wheel must not be resynchronized while it is polled
+        _sleep_requested = true;
+        break;
+
+    case TimerStep: runStep(); break;
+
+    default:
+        if (id >= TimerInputTimeout && id < TimerInputTimeout + MAX_PLAYERS) {
+            // No input from the player in time
+            finishPlayer(id - TimerInputTimeout, false);
+        }
+        break;
     }
 }
 
 void Game::onEnterInitialState() {
     sequence.clear();
-    button_index = 0;
+    if (!_resuming) {
+        Snapshot::discard(); // The game is over, nothing to resume
+    }
+    _sleep_requested = false;
+    _buttons.resume(); // Paused since the countdown
+    restartIdle();
+    armPowerTimers();
+}
+
+void Game::restartIdle() {
+    // The first loop renders the idle page from scratch
+    showIdlePage(0);
+    _timers.arm(TimerIdlePage, _config.idle_page_ms, Fsm::INITIAL_STATE, _config.idle_page_ms);
+    _timers.arm(
+        TimerIdleRainbow, _config.idle_rainbow_ms, Fsm::INITIAL_STATE, _config.idle_rainbow_ms);
+}
+
+void Game::armPowerTimers() {
+    _timers.arm(TimerPowerDim, _config.power_dim_s * 1000UL, Fsm::INITIAL_STATE);
+    _timers.arm(TimerPowerSleep, _config.power_sleep_s * 1000UL, Fsm::INITIAL_STATE);
+}
+
+void Game::enterSleep() {
+    _leds.clearNow();
+    _buzzer.suspend();
+    _oled.power(false);
+
+    uint32_t slept_ms;
+    {
+        Supervisor::Scope scope(Supervisor::ScopeSleep);
+        Supervisor::suspend(); // The sleep lasts until a button is pressed
+        slept_ms = _power.sleep();
+        Supervisor::resume();
+    }
+
+    // Skip the time spent asleep instead of catching up with every timer tick
+    _timers.begin(millis());
+    _buzzer.resume();
+    _oled.power(true);
+
+    Serial.print(F("Woke up after "));
+    Serial.print(slept_ms / 1000);
+    Serial.println(F(" s"));
+    _power.printReport();
+
+    wakeUp();
+    armPowerTimers();
+
+    // The reset button is not a game button, no release follows to end the wake-up
+    if (_power.wakePin() == _config.reset_button_pin) {
+        _waking = false;
+    }
+}
+
+void Game::wakeUp() {
+    _power.wake();
+    _oled.dim(false);
+    _waking = true;
+    restartIdle();
 }
 
 void Game::onEnterGameStartState() {
-    _display.clearDisplay();
-    _display.setTextSize(2);
-    _display.setCursor(0, 0);
-    _display.setTextColor(SSD1306_WHITE);
-    _display.display();
-    _buzzer.playCountdownSound();
-    delay(1000); // Short delay before starting the game
+    // No input until the sequence has been shown
+    _buttons.pause();
+    startSteps(StepFunction::bind<Game, &Game::gameStartStep>(this));
+}
 
-    _buzzer.playCountdownSound();
-    _display.println(FPSTR(STR_READY));
-    _display.display();
-    delay(1000); // Show the message for 1 second
+uint32_t Game::gameStartStep(uint8_t step) {
+    switch (step) {
+    case 0: return 500; // Short pause after the start press
 
-    _buzzer.playCountdownSound();
-    _display.println(FPSTR(STR_START_GAME));
-    _display.display();
-    delay(1000); // Show the message for 1 second
+    case 1:
+        _display.clearDisplay();
+        _display.setTextSize(2);
+        _display.setCursor(0, 0);
+        _display.setTextColor(SSD1306_WHITE);
+        _oled.flush();
+        _buzzer.playCountdownSound();
+        return 1000; // Short delay before starting the game
+
+    case 2:
+        _buzzer.playCountdownSound();
+        _display.println(FPSTR(STR_READY));
+        _oled.flush();
+        return 1000; // Show the message for 1 second
 
-    _buzzer.toneStart(NOTE_C6, 500);
-    _display.println(FPSTR(STR_GO));
-    _display.display();
-    delay(1000); // Show the message for 1 second
+    case 3:
+        _buzzer.playCountdownSound();
+        _display.println(FPSTR(STR_START_GAME));
+        _oled.flush();
+        return 1000; // Show the message for 1 second
+
+    case 4:
+        _buzzer.toneStart(NOTE_C6, 500);
+        _display.println(FPSTR(STR_GO));
+        _oled.flush();
+        return 1000; // Show the message for 1 second
+
+    default: break;
+    }
 
     // Reset the game state
-    button_index = 0; // Reset the button index
     sequence.clear(); // Clear the sequence
+    _mode->reset();
+    memset(players, 0, sizeof(players));
+
+    for (auto& stats : _latency) {
+        stats.reset();
+    }
+    _difficulty.reset();
+    _game_start_time = millis();
 
     // Transition to the PLAYING state
-    fsm_handle::dispatch(Fsm::EventType::PLAYING_SEQUENCE_EVENT);
+    Fsm::dispatchFrom<Fsm::GAME_START_STATE, Fsm::PLAYING_SEQUENCE_EVENT>();
+    return STEPS_DONE;
+}
+
+void Game::startSteps(StepFunction steps) {
+    _steps = steps;
+    _step  = 0;
+    runStep();
+}
+
+void Game::runStep() {
+    // The last step usually dispatches the next state, which may start its own steps
+    uint32_t delay_ms = _steps(_step);
+    if (delay_ms == STEPS_DONE) {
+        return;
+    }
+
+    // Cancelled with the state, like the timeouts
+    _step++;
+    _timers.arm(TimerStep, delay_ms, Fsm::currentState());
 }
 
 void Game::onEnterPlayingSequenceState() {
-    // Check if we've reached the maximum sequence length
-    if (sequence.size() >= MAX_SEQUENCE_LENGTH) {
+    // A resumed round already has its sequence
+    bool resumed = _resuming;
+    _resuming    = false;
+
+    // Let the mode prepare the sequence, it fails once the maximum length is reached
+    if (!resumed && !_mode->beginRound(sequence)) {
         // Player has won by reaching the maximum sequence length!
+        startSteps(StepFunction::bind<Game, &Game::totalVictoryStep>(this));
+        return;
+    }
+
+    _input_length = _mode->inputLength(sequence);
+    saveSnapshot();
+
+    // Speed up the playback as the game goes on
+    _difficulty.update(sequence.size(), _latency[_mode->currentPlayer()]);
+
+    _leds.clearNow();
+
+    // Blank screen, the color name widget is updated by the timeline
+    _scene.reset();
+    _color_widget = _scene.addText(STR_EMPTY, 0, 0);
+    _scene.render(_display, _oled, _text, millis());
+
+    // Inputs are ignored while the sequence is shown
+    _buttons.pause();
+
+    // Compile the playback, it is then executed by onLoopPlayingSequenceState
+    compileSequence(_timeline,
+                    sequence,
+                    _mode->playbackStart(sequence),
+                    _difficulty.timing(),
+                    SEQUENCE_LEAD_IN_MS);
+    _playback.start(_timeline, micros());
+}
+
+uint32_t Game::totalVictoryStep(uint8_t step) {
+    if (step == 0) {
         _display.clearDisplay();
         _display.setTextSize(2);
         _display.setCursor(0, 0);
@@ -423,323 +969,640 @@ void Game::onEnterPlayingSequenceState() {
         _display.println(FPSTR(STR_TOTAL));
         _display.println(FPSTR(STR_SEQUENCE));
         _display.println(FPSTR(STR_MAXIMUM));
-        _display.display();
-        delay(3000);
+        _oled.flush();
+        return 3000;
+    }
+
+    // Set new high score and return to initial state
+    _high_score = MAX_SEQUENCE_LENGTH;
+    _preferences.putUInt("high_score", _high_score);
+    Fsm::dispatchFrom<Fsm::PLAYING_SEQUENCE_STATE, Fsm::INITIAL_STATE_EVENT>();
+    return STEPS_DONE;
+}
+
+void Game::onLoopPlayingSequenceState() {
+    if (_timers.isArmed(TimerStep)) {
+        return; // Total victory, there is no round to play
+    }
 
-        // Set new high score and return to initial state
-        _high_score = MAX_SEQUENCE_LENGTH;
-        _preferences.putUInt("high_score", _high_score);
-        fsm_handle::dispatch(Fsm::EventType::INITIAL_STATE_EVENT);
+    timeline_action_t action;
+    while (_playback.poll(micros(), action)) {
+        runTimelineAction(action);
+    }
+
+    if (_playback.isPlaying()) {
         return;
     }
 
-    // Add the next color to the sequence
-    button_index = 0; // Reset the button index for the new sequence
-    sequence.push_back(next_color());
+    Serial.print(F("Playback jitter: max "));
+    Serial.print(_playback.jitterMaxUs());
+    Serial.print(F(" us, avg "));
+    Serial.print(_playback.jitterAvgUs());
+    Serial.print(F(" us over "));
+    Serial.print(_playback.jitterCount());
+    Serial.println(F(" actions"));
 
-    _leds.clearNow();
-    _display.clearDisplay();
-    _display.display();
+    _buttons.resume();
 
-    delay(500);
+    // After showing the sequence, transition to the PLAYING_USER_STATE
+    Fsm::dispatchFrom<Fsm::PLAYING_SEQUENCE_STATE, Fsm::PLAYING_USER_EVENT>();
+}
 
-    // now play the sequence
-    for (const auto& c : sequence) {
-        _buzzer.toneStart(colorToNote(c), 500); // Play the corresponding note
-        _leds.showColor(c, 0);                  // Show each color for 500 ms
-        _display.clearDisplay();
-        _display.setCursor(0, 0);
-        _display.setTextSize(2);
-        _display.println(colorToString(c));
-        _display.display();
+void Game::saveSnapshot() {
+    game_snapshot_t snapshot;
+    snapshot.mode       = _mode_index;
+    snapshot.mode_state = _mode->saveState();
+    snapshot.out        = 0;
+    for (uint8_t p = 0; p < MAX_PLAYERS; p++) {
+        snapshot.out |= players[p].out << p;
+        snapshot.scores[p] = players[p].score;
+    }
+    Snapshot::save(snapshot, sequence, _mode->changedFrom(sequence));
+}
+
+void Game::resumeGame(const game_snapshot_t& snapshot, const Sequence& saved) {
+    if (_splash) {
+        endSplash();
+    }
 
-        delay(700); // Wait for 500 ms before showing the next color
+    // Same reset as a new game, then the recorded state
+    selectMode(snapshot.mode);
+    _mode->reset();
+    _mode->restoreState(snapshot.mode_state);
+    sequence = saved;
 
-        _leds.clearNow(); // Clear the LEDs after showing each color
-        delay(100);       // Short delay before the next color
+    memset(players, 0, sizeof(players));
+    for (uint8_t p = 0; p < MAX_PLAYERS; p++) {
+        players[p].out   = snapshot.out & (1 << p);
+        players[p].score = snapshot.scores[p];
     }
+    for (auto& stats : _latency) {
+        stats.reset();
+    }
+    _difficulty.reset();
+    _game_start_time = millis();
 
-    // After showing the sequence, transition to the PLAYING_USER_STATE
-    fsm_handle::dispatch(Fsm::EventType::PLAYING_USER_EVENT);
+    Serial.print(F("Resuming the game at round "));
+    Serial.println(sequence.size());
+
+    _resuming = true;
+    Fsm::dispatchFrom<Fsm::INITIAL_STATE, Fsm::PLAYING_SEQUENCE_EVENT>();
 }
 
-void Game::onEnterPlayingUserState() {
-    _leds.clearNow();
-    _display.clearDisplay();
-    _display.setTextSize(2);
-    _display.setCursor(0, 0);
-    _display.println(FPSTR(STR_PRESS_THE));
-    _display.println(FPSTR(STR_RIGHT_BUTTON));
-    _display.display();
+void Game::runTimelineAction(const timeline_action_t& action) {
+    color_t color = static_cast<color_t>(action.arg);
 
-    button_timer = millis(); // Start the timer for button press duration
-}
+    switch (action.type) {
+    case ActionLedOn:   _leds.showColor(color); break;
 
-void Game::onLoopPlayingUserState() {
-    unsigned long elapsed_time = (millis() - button_timer);
+    case ActionLedOff:  _leds.clear(LayerFeedback); break;
 
-    if (elapsed_time > IN_SEQUENCE_TIMEOUT) {
-        fsm_handle::dispatch(Fsm::EventType::PLAYING_LOSE_EVENT);
-    }
+    case ActionToneOn:  _buzzer.toneStart(colorToNote(color)); break;
 
-    // if (elapsed_time > 5) {
-    //     // If no button is pressed for 5 seconds, consider it a timeout
-    //     _buzzer.playErrorSound();
-    //     _leds.fill_all(color_t::ColorRed); // Fill LEDs with red color
-    //     delay(500); // Show the error color for 500 ms
+    case ActionToneOff: _buzzer.stop(); break;
 
-    //     _leds.clearNow();
-    //     _display.clearDisplay();
-    //     _display.setCursor(0, 0);
-    //     _display.setTextSize(2);
-    //     _display.println(F("Tempo scaduto!"));
-    //     _display.display();
-    //     delay(2000); // Show the message for 2 seconds
-    // }
+    case ActionDisplay:
+        // Only the color name is re-rasterized and flushed
+        _scene.setText(_color_widget, colorToName(color));
+        _scene.render(_display, _oled, _text, millis());
+        break;
+
+    default: break;
+    }
+}
+
+void Game::onEnterPlayingUserState() {
+    _leds.clearNow();
+    _scene.reset();
+    if (_mode->concurrent()) {
+        _scene.addText(_mode->name(), 0, 0);
+    } else if (_mode->players() > 1) {
+        _scene.addText(STR_TURN, 0, 0);
+        _scene.addNumber(_mode->currentPlayer() + 1, 72, 0);
+    } else {
+        _scene.addText(STR_PRESS_THE, 0, 0);
+    }
+    _scene.addText(STR_RIGHT_BUTTON, 0, 2);
+    _scene.render(_display, _oled, _text, millis());
+
+    // Every player still in the game answers at once in concurrent modes,
+    // otherwise only the player whose turn it is
+    uint32_t now_us = micros();
+
+    for (uint8_t p = 0; p < _mode->players(); p++) {
+        player_state_t& state = players[p];
+        state.button_index    = 0;
+        state.passed          = false;
+        state.active = !state.out && (_mode->concurrent() || p == _mode->currentPlayer());
+        _reaction[p].beginRound(now_us);
+
+        if (state.active) {
+            _timers.arm(TimerInputTimeout + p, _config.input_timeout_ms, Fsm::PLAYING_USER_STATE);
+        }
+    }
 }
 
 void Game::onEnterPlayingWinState() {
-    delay(500);
+    _buttons.pause(); // Until the next sequence has been shown
+    startSteps(StepFunction::bind<Game, &Game::winStep>(this));
+}
 
-    _leds.clearNow();
+uint32_t Game::winStep(uint8_t step) {
+    switch (step) {
+    case 0: return 500;
 
-    _display.clearDisplay();
-    _display.setTextSize(2);
-    _display.setCursor(0, 0);
-    _display.println(FPSTR(STR_GREAT));
-    _display.display();
+    case 1:
+        _leds.clearNow();
 
-    _buzzer.playRoundWinSound();
+        _display.clearDisplay();
+        _display.setTextSize(2);
+        _display.setCursor(0, 0);
+        _display.println(FPSTR(STR_GREAT));
+        _oled.flush();
 
-    _leds.rainbow(2, 1);
-    _leds.clearNow();
+        _buzzer.playRoundWinSound();
+        startRainbow(750);
+        return 750;
 
-    delay(500);
+    case 2:
+        _rainbow = false;
+        _leds.clearNow();
+        return 500;
+
+    case 3:
+        _display.print(FPSTR(STR_ROUND));
+        _display.println(sequence.size());
+        _oled.flush();
+        return 500;
 
-    _display.print(FPSTR(STR_ROUND));
-    _display.println(sequence.size());
-    _display.display();
-    delay(500);
+    default: break;
+    }
 
-    fsm_handle::dispatch(Fsm::EventType::PLAYING_SEQUENCE_EVENT);
+    Fsm::dispatchFrom<Fsm::PLAYING_WIN_STATE, Fsm::PLAYING_SEQUENCE_EVENT>();
+    return STEPS_DONE;
 }
 
 void Game::onEnterPlayingLoseState() {
-    _leds.clearNow();
+    _buttons.pause(); // Until the idle screen is back
+    startSteps(StepFunction::bind<Game, &Game::loseStep>(this));
+}
 
-    _buzzer.playErrorSound();
-    _leds.fill_all(color_t::ColorRed); // Fill LEDs with red color
-    delay(ERROR_TONE_DURATION);
+uint32_t Game::loseStep(uint8_t step) {
+    uint8_t player_count = _mode->players();
 
-    _leds.clearNow();
+    if (step == 0) {
+        Snapshot::discard();
+        _leds.clearNow();
+
+        _buzzer.playErrorSound();
+        _leds.fill_all(color_t::ColorRed); // Fill LEDs with red color
+        return ERROR_TONE_DURATION;
+    }
+
+    if (step == 1) {
+        _leds.clearNow();
+        displayResult();
+        return 2000;
+    }
 
+    if (step < player_count + 2) {
+        // One screen per player, skipped when there is nothing to show
+        uint8_t player = step - 2;
+        saveReactionStats(player);
+        return displayReactionStats(player) ? 2000 : 0;
+    }
+
+    if (step == player_count + 2) {
+        printThroughput();
+        Memory::printReport();
+
+        // Check if the current score is higher than the high score
+        if (_best_score > _high_score) {
+            _high_score = _best_score;
+            _preferences.putUInt("high_score", _high_score); // Save the new high score
+            _display.clearDisplay();
+            _display.setTextSize(2);
+            _display.setCursor(0, 0);
+            _display.println(FPSTR(STR_NEW));
+            _display.println(FPSTR(STR_RECORD_EXCL));
+            _display.println(_high_score);
+            _oled.flush();
+
+            // Epic synchronized celebration with sound, lights, and fireworks!
+            startCelebration();
+            return CELEBRATION_LIGHTS_MS + CELEBRATION_FINALE_MS;
+        }
+    }
+
+    // Transition back to the initial state
+    Fsm::dispatchFrom<Fsm::PLAYING_LOSE_STATE, Fsm::INITIAL_STATE_EVENT>();
+    return STEPS_DONE;
+}
+
+void Game::displayResult() {
     _display.clearDisplay();
     _display.setTextSize(2);
     _display.setCursor(0, 0);
-    _display.println(FPSTR(STR_YOU_LOST));
-    _display.display();
-    delay(2000);
-
-    // Check if the current score is higher than the high score
-    if (sequence.size() > _high_score) {
-        _high_score = sequence.size();
-        _preferences.putUInt("high_score", _high_score); // Save the new high score
-        _display.clearDisplay();
-        _display.setTextSize(2);
-        _display.setCursor(0, 0);
-        _display.println(FPSTR(STR_NEW));
-        _display.println(FPSTR(STR_RECORD_EXCL));
-        _display.println(_high_score);
-        _display.display();
+    // The best final score of the game, and who reached it
+    uint8_t best_player = 0;
+    bool tie            = false;
+    _best_score         = 0;
+    for (uint8_t p = 0; p < _mode->players(); p++) {
+        player_state_t& state = players[p];
+        if (!state.out) {
+            state.score = sequence.size(); // Still in when the game ended
+        }
 
-        // Epic synchronized celebration with sound, lights, and fireworks!
-        synchronizedCelebration();
+        if (p == 0 || state.score > _best_score) {
+            _best_score = state.score;
+            best_player = p;
+            tie         = false;
+        } else if (state.score == _best_score) {
+            tie = true;
+        }
     }
 
-    fsm_handle::dispatch(
-        Fsm::EventType::INITIAL_STATE_EVENT); // Transition back to the initial state
+    if (_mode->concurrent()) {
+        _display.println(FPSTR(tie ? STR_TIE : STR_WINNER));
+        if (!tie) {
+            _display.print(FPSTR(STR_PLAYER));
+            _display.println(best_player + 1);
+        }
+    } else {
+        _display.println(FPSTR(STR_YOU_LOST));
+        if (_mode->players() > 1) {
+            _display.print(FPSTR(STR_PLAYER));
+            _display.println(_mode->currentPlayer() + 1);
+        }
+    }
+    _oled.flush();
 }
 
-void Game::testCelebrationEffects() {
-    Serial.println(F("🎉 Testing celebration effects!"));
+bool Game::displayReactionStats(uint8_t player) {
+    const LatencyStats& stats = _latency[player];
+
+    Serial.print(F("Reaction latency (player "));
+    Serial.print(player + 1);
+    Serial.print(F(", "));
+    Serial.print(stats.count());
+    Serial.print(F(" inputs): min "));
+    Serial.print(stats.minMs());
+    Serial.print(F(" ms, median "));
+    Serial.print(stats.medianMs());
+    Serial.print(F(" ms, p95 "));
+    Serial.print(stats.p95Ms());
+    Serial.println(F(" ms"));
+
+    if (stats.count() == 0) {
+        return false; // Nothing worth showing
+    }
 
-    // Display test message
     _display.clearDisplay();
     _display.setTextSize(2);
     _display.setCursor(0, 0);
-    _display.println(FPSTR(STR_TESTING));
-    _display.println(FPSTR(STR_CELEBRATION));
-    _display.println(FPSTR(STR_EFFECTS));
-    _display.display();
+    _display.println(FPSTR(STR_REACTION));
 
-    // Synchronized celebration - lights and sound together!
-    synchronizedCelebration();
+    _display.print(FPSTR(STR_LATENCY_MIN));
+    _display.print(stats.minMs());
+    _display.println(FPSTR(STR_MS));
 
-    Serial.println(F("✨ Celebration test complete!"));
+    _display.print(FPSTR(STR_LATENCY_MEDIAN));
+    _display.print(stats.medianMs());
+    _display.println(FPSTR(STR_MS));
 
-    // Return to normal display after a moment
-    delay(1000);
-    _display.clearDisplay();
-    _display.display();
+    _display.print(FPSTR(STR_LATENCY_P95));
+    _display.print(stats.p95Ms());
+    _display.println(FPSTR(STR_MS));
+    _oled.flush();
+    return true;
 }
 
-void Game::synchronizedCelebration() {
-    // Start the smooth Pacman melody in the background
-    _buzzer.playNewHighScoreSound();
+void Game::saveReactionStats(uint8_t player) {
+    const LatencyStats& stats = _latency[player];
+    if (stats.count() == 0 || !_health.has(CapStorage)) {
+        return;
+    }
 
-    // Create visual celebration with lights and display fireworks!
-    const int celebrationSteps = 30;
-    const int stepDuration     = 150; // 150ms per step = ~4.5 seconds total
-
-    for (int step = 0; step < celebrationSteps; step++) {
-        // Synchronized light effects
-        switch (step % 6) {
-        case 0:
-        case 1:
-            // Rainbow burst
-            _leds.rainbow(1, 1);
-            break;
-        case 2:
-            // Red flash
-            _leds.fill_all(color_t::ColorRed);
-            break;
-        case 3:
-            // Blue flash
-            _leds.fill_all(color_t::ColorBlue);
-            break;
-        case 4:
-            // Green flash
-            _leds.fill_all(color_t::ColorGreen);
-            break;
-        case 5:
-            // Yellow flash
-            _leds.fill_all(color_t::ColorYellow);
-            break;
-        }
+    // Latency of the last game, used to tune IN_SEQUENCE_TIMEOUT and difficulty.
+    // One set of keys per player, e.g. "p1_lat_count"
+    char key[16];
+    Supervisor::Scope scope(Supervisor::ScopeStorage);
+    snprintf(key, sizeof(key), "p%d_lat_count", player + 1);
+    _preferences.putUInt(key, stats.count());
+    snprintf(key, sizeof(key), "p%d_lat_min", player + 1);
+    _preferences.putUInt(key, stats.minMs());
+    snprintf(key, sizeof(key), "p%d_lat_median", player + 1);
+    _preferences.putUInt(key, stats.medianMs());
+    snprintf(key, sizeof(key), "p%d_lat_p95", player + 1);
+    _preferences.putUInt(key, stats.p95Ms());
+}
 
-        // Synchronized display fireworks
-        drawFireworks(step);
+void Game::registerMemory() {
+    Memory::addStatic(Memory::ModuleLeds, sizeof(_leds) + sizeof(strip));
+    Memory::addStatic(Memory::ModuleButtons, sizeof(_buttons));
+    Memory::addStatic(Memory::ModuleBuzzer, sizeof(_buzzer));
 
-        delay(stepDuration);
+    uint32_t display = sizeof(_display) + sizeof(_oled) + sizeof(_text) + sizeof(_scene) +
+                       sizeof(_frames) + sizeof(_particles);
+    Memory::addStatic(Memory::ModuleDisplay, display);
 
-        // Clear LEDs between some steps for sparkle effect
-        if (step % 2 == 1) {
-            _leds.clearNow();
-            delay(30);
+    // Everything else in the game object, plus the shared game globals
+    uint32_t game = sizeof(Game) - sizeof(_leds) - sizeof(_buttons) - sizeof(_buzzer) - display;
+    Memory::addStatic(Memory::ModuleGame,
+                      game + sizeof(sequence) + sizeof(players) + sizeof(_preferences));
+}
+
+void Game::registerConsole() {
+    _console.addCommand("get",
+                        "[name]: show the settings",
+                        Console::CommandFunction::bind<Game, &Game::onGetCommand>(this));
+    _console.addCommand("set",
+                        "<name> <value>: change a setting",
+                        Console::CommandFunction::bind<Game, &Game::onSetCommand>(this));
+    _console.addCommand("save",
+                        "store the settings in NVS",
+                        Console::CommandFunction::bind<Game, &Game::onSaveCommand>(this));
+    _console.addCommand("stats",
+                        "self-test, power, memory and frame reports",
+                        Console::CommandFunction::bind<Game, &Game::onStatsCommand>(this));
+    _console.addCommand("state",
+                        "current FSM state",
+                        Console::CommandFunction::bind<Game, &Game::onStateCommand>(this));
+    _console.addCommand("celebrate",
+                        "play the celebration (idle screen only)",
+                        Console::CommandFunction::bind<Game, &Game::onCelebrateCommand>(this));
+    _console.addCommand("press",
+                        "<color> [bank]: hold a button down",
+                        Console::CommandFunction::bind<Game, &Game::onButtonCommand>(this));
+    _console.addCommand("release",
+                        "<color> [bank]: release a button",
+                        Console::CommandFunction::bind<Game, &Game::onButtonCommand>(this));
+}
+
+void Game::applyConfig() {
+    _leds.configure();
+    _buttons.configure();
+    _buzzer.configure();
+}
+
+void Game::onGetCommand(uint8_t argc, char** argv) {
+    if (argc < 2) {
+        for (uint8_t i = 0; i < Settings::fieldsCount(); i++) {
+            Settings::print(_config, Settings::field(i));
         }
+        return;
     }
 
-    // Final fireworks burst on display
-    drawFinalFireworks();
-    _leds.clearNow();
+    const Settings::field_t* field = Settings::find(argv[1]);
+    if (field == nullptr) {
+        Serial.print(F("Unknown setting: "));
+        Serial.println(argv[1]);
+        return;
+    }
+    Settings::print(_config, *field);
 }
 
-void Game::drawFireworks(int step) {
-    _display.clearDisplay();
+void Game::onSetCommand(uint8_t argc, char** argv) {
+    const Settings::field_t* field = argc > 2 ? Settings::find(argv[1]) : nullptr;
+    if (field == nullptr) {
+        Serial.println(F("Usage: set <name> <value>"));
+        return;
+    }
 
-    // Draw multiple fireworks at different stages
-    int firework1_stage = step % 8;
-    int firework2_stage = (step + 4) % 8;
+    char* end;
+    unsigned long value = strtoul(argv[2], &end, 10);
+    if (*end != '\0' || value < field->min || value > field->max) {
+        Serial.println(F("Error: invalid value"));
+    } else {
+        _config.*field->value = value;
+        applyConfig();
+    }
+    Settings::print(_config, *field);
+}
 
-    // Firework 1 (center-left)
-    drawSingleFirework(32, 32, firework1_stage);
+void Game::onSaveCommand(uint8_t, char**) {
+    if (!Settings::validate(_config)) {
+        Serial.println(F("Warning: invalid settings replaced with the defaults"));
+        applyConfig();
+    }
+    Serial.println(Settings::save(_config) ? F("Settings saved") : F("Error: settings not saved"));
+}
+
+void Game::onStatsCommand(uint8_t, char**) {
+    _health.printReport();
+    _power.printReport();
+    Supervisor::printReport();
+    _oled.printReport();
+    Memory::printReport();
+    _frames.printStats();
+}
 
-    // Firework 2 (center-right)
-    drawSingleFirework(96, 32, firework2_stage);
+void Game::onStateCommand(uint8_t, char**) {
+    Serial.print(F("State: "));
+    Serial.println(Fsm::stateTypeToString(Fsm::currentState()));
+}
 
-    // Add some random sparkles
-    for (int i = 0; i < 8; i++) {
-        int x = random(0, SCREEN_WIDTH);
-        int y = random(0, SCREEN_HEIGHT);
-        _display.drawPixel(x, y, SSD1306_WHITE);
+void Game::onCelebrateCommand(uint8_t, char**) {
+    if (Fsm::currentState() != Fsm::INITIAL_STATE || _timers.isArmed(TimerStep)) {
+        Serial.println(F("Error: only available on the idle screen"));
+        return;
     }
+    testCelebrationEffects();
+}
 
-    // Add celebration text
-    _display.setTextSize(1);
-    _display.setCursor(40, 0);
-    _display.print(FPSTR(STR_RECORD_SHORT));
+void Game::onButtonCommand(uint8_t argc, char** argv) {
+    uint8_t bank = argc > 2 ? atoi(argv[2]) : 0;
+    if (argc < 2 || bank >= _buttons.getBanksCount()) {
+        Serial.println(F("Usage: press|release <color> [bank]"));
+        return;
+    }
 
-    _display.display();
+    for (uint8_t i = 0; i < COLORS_COUNT; i++) {
+        if (strcmp(argv[1], _buttons.getButton(bank, i).getName()) == 0) {
+            // Goes through the debouncing like a real press
+            _buttons.inject(bank, i, strcmp(argv[0], "press") == 0);
+            return;
+        }
+    }
+
+    Serial.print(F("Unknown color: "));
+    Serial.println(argv[1]);
 }
 
-void Game::drawSingleFirework(int centerX, int centerY, int stage) {
-    switch (stage) {
+void Game::printThroughput() {
+    unsigned long elapsed = millis() - _game_start_time;
+    if (elapsed == 0) {
+        return;
+    }
+
+    // Rounds per minute with one decimal, using integer math only
+    uint32_t rpm_x10 = (static_cast<uint32_t>(sequence.size()) * 600000UL) / elapsed;
+
+    Serial.print(F("Throughput: "));
+    Serial.print(rpm_x10 / 10);
+    Serial.print('.');
+    Serial.print(rpm_x10 % 10);
+    Serial.print(F(" rounds/min, final step "));
+    Serial.print(_difficulty.timing().on_ms);
+    Serial.print('+');
+    Serial.print(_difficulty.timing().off_ms);
+    Serial.println(F(" ms"));
+}
+
+void Game::testCelebrationEffects() {
+    Serial.println(F("🎉 Testing celebration effects!"));
+
+    if (_splash) {
+        endSplash();
+    }
+    armPowerTimers(); // Not dimmed halfway through
+    startSteps(StepFunction::bind<Game, &Game::celebrationTestStep>(this));
+}
+
+uint32_t Game::celebrationTestStep(uint8_t step) {
+    switch (step) {
     case 0:
+        // Display test message
+        _display.clearDisplay();
+        _display.setTextSize(2);
+        _display.setCursor(0, 0);
+        _display.println(FPSTR(STR_TESTING));
+        _display.println(FPSTR(STR_CELEBRATION));
+        _display.println(FPSTR(STR_EFFECTS));
+        _oled.flush();
+
+        // Synchronized celebration - lights and sound together!
+        startCelebration();
+        return CELEBRATION_LIGHTS_MS + CELEBRATION_FINALE_MS;
+
     case 1:
-        // Launch phase - vertical line moving up
-        for (int i = 0; i < stage * 10; i++) {
-            _display.drawPixel(centerX, centerY + 20 - i, SSD1306_WHITE);
+        Serial.println(F("✨ Celebration test complete!"));
+        return 1000; // Return to normal display after a moment
+
+    default: break;
+    }
+
+    restartIdle();
+    return STEPS_DONE;
+}
+
+void Game::startCelebration() {
+    // Start the smooth Pacman melody in the background
+    _buzzer.playNewHighScoreSound();
+
+    _particles.clear();
+    _frames.begin(FRAME_PIPELINE_FPS);
+
+    // The flashes tint the moving rainbow instead of replacing it
+    _leds.setBlend(LayerAlert, BlendAdd, 160);
+
+    // Played by the loop, one frame per slot of the pipeline
+    _celebrating          = true;
+    _celebration_start_ms = millis();
+    _celebration_step     = -1;
+    _celebration_frame    = 0;
+    _celebration_finale   = false;
+}
+
+void Game::celebrationFrame(uint32_t now_ms) {
+    uint32_t elapsed = now_ms - _celebration_start_ms;
+    if (elapsed >= CELEBRATION_LIGHTS_MS + CELEBRATION_FINALE_MS) {
+        stopCelebration();
+        return;
+    }
+
+    if (!_frames.frameDue()) {
+        return;
+    }
+    _frames.compose();
+
+    if (elapsed < CELEBRATION_LIGHTS_MS) {
+        // Synchronized light effects over a rainbow that keeps moving (half a turn
+        // per second, whatever the frame rate)
+        _leds.rainbowFrame(Leds::rainbowHue(elapsed, 32768));
+        int16_t step = elapsed / CELEBRATION_STEP_MS;
+        if (step != _celebration_step) {
+            _celebration_step = step;
+            celebrationLights(step);
+        } else if (step % 2 == 1 && elapsed % CELEBRATION_STEP_MS >= CELEBRATION_STEP_MS - 30) {
+            _leds.clear(LayerAlert); // Short gap for a sparkle effect
         }
-        break;
 
-    case 2:
-    case 3: {
-        // Small explosion
-        int radius1 = (stage - 1) * 3;
-        for (int angle = 0; angle < 360; angle += 45) {
-            int x = centerX + (radius1 * cos(angle * PI / 180));
-            int y = centerY + (radius1 * sin(angle * PI / 180));
-            if (x >= 0 && x < SCREEN_WIDTH && y >= 0 && y < SCREEN_HEIGHT) {
-                _display.drawPixel(x, y, SSD1306_WHITE);
-            }
+        // A rocket every few frames, sparkles all the time
+        if (_celebration_frame % 8 == 0) {
+            _particles.launch(random(16, SCREEN_WIDTH - 16), random(8, SCREEN_HEIGHT / 2));
         }
-        break;
+        _particles.sparkle(1, 6);
+    } else if (!_celebration_finale) {
+        // Final fireworks burst across the screen
+        _celebration_finale = true;
+        _leds.clearNow();
+        for (int fw = 0; fw < 4; fw++) {
+            _particles.burst(20 + fw * 28, 20 + random(-10, 10), 16, 40, 24);
+        }
+    }
+
+    // Only the lights without a display
+    if (_health.has(CapDisplay)) {
+        _particles.update();
+        drawCelebrationFrame(_celebration_finale);
+        _frames.present(_display.getBuffer());
     }
+    _celebration_frame++;
+}
 
+void Game::stopCelebration() {
+    _celebrating = false;
+    _frames.finish();
+    _frames.printStats();
+    _leds.setBlend(LayerAlert, BlendAlpha);
+    _leds.clearNow();
+}
+
+void Game::celebrationLights(int step) {
+    switch (step % 6) {
+    case 0:
+    case 1:
+        // Rainbow burst
+        _leds.clear(LayerAlert);
+        break;
+    case 2:
+        // Red flash
+        _leds.fill_all(color_t::ColorRed);
+        break;
+    case 3:
+        // Blue flash
+        _leds.fill_all(color_t::ColorBlue);
+        break;
     case 4:
+        // Green flash
+        _leds.fill_all(color_t::ColorGreen);
+        break;
     case 5:
-    case 6: {
-        // Large explosion with spokes
-        int radius2 = (stage - 2) * 4;
-        for (int angle = 0; angle < 360; angle += 30) {
-            int x1 = centerX + (radius2 * cos(angle * PI / 180));
-            int y1 = centerY + (radius2 * sin(angle * PI / 180));
-            if (x1 >= 0 && x1 < SCREEN_WIDTH && y1 >= 0 && y1 < SCREEN_HEIGHT) {
-                _display.drawLine(centerX, centerY, x1, y1, SSD1306_WHITE);
-            }
-        }
+        // Yellow flash
+        _leds.fill_all(color_t::ColorYellow);
         break;
     }
+}
 
-    case 7: {
-        // Fading sparkles
-        for (int i = 0; i < 6; i++) {
-            int x = centerX + random(-15, 15);
-            int y = centerY + random(-15, 15);
-            if (x >= 0 && x < SCREEN_WIDTH && y >= 0 && y < SCREEN_HEIGHT) {
-                _display.drawPixel(x, y, SSD1306_WHITE);
-            }
-        }
-        break;
-    }
+void Game::drawCelebrationFrame(bool finale) {
+    uint8_t* buffer = _display.getBuffer();
+    if (buffer == nullptr) {
+        return; // Display not initialized
     }
-}
 
-void Game::drawFinalFireworks() {
+    // Composed in the back buffer while the previous frame is still being sent
     _display.clearDisplay();
+    _particles.draw(buffer);
 
-    // Multiple large fireworks across the screen
-    for (int fw = 0; fw < 4; fw++) {
-        int centerX = 20 + fw * 25;
-        int centerY = 20 + random(-10, 20);
-
-        // Large starburst
-        for (int angle = 0; angle < 360; angle += 15) {
-            int x = centerX + (15 * cos(angle * PI / 180));
-            int y = centerY + (15 * sin(angle * PI / 180));
-            if (x >= 0 && x < SCREEN_WIDTH && y >= 0 && y < SCREEN_HEIGHT) {
-                _display.drawLine(centerX, centerY, x, y, SSD1306_WHITE);
-            }
-        }
-    }
-
-    // Victory text
     _display.setTextSize(1);
-    _display.setCursor(30, 50);
-    _display.print(FPSTR(STR_NEW_RECORD));
-
-    _display.display();
-    delay(1000);
+    if (finale) {
+        _display.setCursor(30, 50);
+        _display.print(FPSTR(STR_NEW_RECORD));
+    } else {
+        _display.setCursor(40, 0);
+        _display.print(FPSTR(STR_RECORD_SHORT));
+    }
 }
 
 void Game::resetHighScore() {
@@ -749,42 +1612,52 @@ void Game::resetHighScore() {
     _high_score = 0;
     _preferences.putUInt("high_score", _high_score);
 
-    // Show reset notification
-    _display.clearDisplay();
-    _display.setTextSize(2);
-    _display.setCursor(0, 0);
-    _display.println(FPSTR(STR_RESET_RECORD));
-    _display.println(FPSTR(STR_RECORD_RESET));
-    _display.display();
-    delay(1500);
-
-    _display.clearDisplay();
-    _display.setTextSize(2);
-    _display.setCursor(0, 0);
-    _display.println(FPSTR(STR_RECORD_CLEARED));
-    _display.println(FPSTR(STR_CLEARED));
-    _display.display();
+    if (_celebrating) {
+        stopCelebration();
+    }
+    armPowerTimers();
+    startSteps(StepFunction::bind<Game, &Game::resetHighScoreStep>(this));
+}
 
-    // Visual feedback with LEDs
-    for (int i = 0; i < 3; i++) {
-        _leds.fill_all(color_t::ColorRed);
-        delay(200);
-        _leds.clearNow();
-        delay(200);
+uint32_t Game::resetHighScoreStep(uint8_t step) {
+    if (step == 0) {
+        // Show reset notification
+        _display.clearDisplay();
+        _display.setTextSize(2);
+        _display.setCursor(0, 0);
+        _display.println(FPSTR(STR_RESET_RECORD));
+        _display.println(FPSTR(STR_RECORD_RESET));
+        _oled.flush();
+        return 1500;
     }
 
-    delay(2000);
+    if (step == 1) {
+        _display.clearDisplay();
+        _display.setTextSize(2);
+        _display.setCursor(0, 0);
+        _display.println(FPSTR(STR_RECORD_CLEARED));
+        _display.println(FPSTR(STR_CLEARED));
+        _oled.flush();
+    }
 
-    // Clear display and return to normal state
-    _display.clearDisplay();
-    _display.display();
+    if (step <= 6) {
+        // Visual feedback with LEDs: three red flashes
+        if (step % 2 == 1) {
+            _leds.fill_all(color_t::ColorRed);
+        } else {
+            _leds.clearNow();
+        }
+        return step < 6 ? 200 : 2000;
+    }
 
+    // Return to the idle screen
+    restartIdle();
     Serial.println(F("✅ High score reset complete!"));
+    return STEPS_DONE;
 }
 
 Fsm::StateType Game::getCurrentState() {
-    auto currentState = fsm_handle::currentState();
-    return currentState.getType();
+    return Fsm::currentState();
 }
 
 } // namespace simon
@@ -0,0 +1,53 @@
+#include "health.h"
+
+using namespace simon;
+
+static const char CAP_DISPLAY[] PROGMEM = "display";
+static const char CAP_LEDS[] PROGMEM    = "leds";
+static const char CAP_BUZZER[] PROGMEM  = "buzzer";
+static const char CAP_BUTTONS[] PROGMEM = "buttons";
+static const char CAP_STORAGE[] PROGMEM = "storage";
+
+static const char* const CAP_NAMES[] = {
+    CAP_DISPLAY,
+    CAP_LEDS,
+    CAP_BUZZER,
+    CAP_BUTTONS,
+    CAP_STORAGE,
+};
+
+bool Health::probeI2C(TwoWire& wire, uint8_t address) {
+    wire.beginTransmission(address);
+    return wire.endTransmission() == 0;
+}
+
+void Health::set(capability_t cap, bool ok) {
+    if (ok) {
+        _caps |= cap;
+    } else {
+        _caps &= ~cap;
+    }
+}
+
+void Health::setStuckButtons(uint16_t mask) {
+    _stuck_buttons = mask;
+    set(CapButtons, mask == 0);
+}
+
+void Health::printReport() const {
+    Serial.print(F("Self-test: 0x"));
+    Serial.print(_caps, HEX);
+
+    for (uint8_t i = 0; i < sizeof(CAP_NAMES) / sizeof(CAP_NAMES[0]); i++) {
+        Serial.print(' ');
+        Serial.print(FPSTR(CAP_NAMES[i]));
+        Serial.print((_caps & (1 << i)) ? F(" ok") : F(" FAILED"));
+    }
+    Serial.println();
+
+    if (_stuck_buttons != 0) {
+        Serial.print(F("Warning: buttons held or stuck at boot: 0x"));
+        Serial.print(_stuck_buttons, HEX);
+        Serial.println(F(", ignored until released"));
+    }
+}
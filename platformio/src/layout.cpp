@@ -0,0 +1,72 @@
+#include "layout.h"
+
+using namespace simon;
+
+bool LedLayout::build(const config_t& config) {
+    const uint16_t count = min<uint16_t>(config.led_count, LED_MAX_PIXELS);
+    uint16_t layout      = config.led_layout;
+    bool valid           = true;
+
+    _width  = count;
+    _height = 1;
+
+    if (layout == LED_LAYOUT_MATRIX || layout == LED_LAYOUT_SERPENTINE) {
+        // Every quadrant needs at least one pixel
+        if (config.led_width < 2 || count % config.led_width != 0 ||
+            count / config.led_width < 2) {
+            Serial.println(F("Error: led_count is not a matrix of led_width columns!"));
+            layout = LED_LAYOUT_STRIP;
+            valid  = false;
+        } else {
+            _width  = config.led_width;
+            _height = count / config.led_width;
+        }
+    }
+
+    for (uint16_t y = 0; y < _height; y++) {
+        for (uint16_t x = 0; x < _width; x++) {
+            uint16_t pixel;
+            switch (layout) {
+            case LED_LAYOUT_RING:       pixel = (x + config.led_offset) % count; break;
+
+            case LED_LAYOUT_SERPENTINE: pixel = y * _width + ((y & 1) ? _width - 1 - x : x); break;
+
+            default:                    pixel = y * _width + x; break;
+            }
+            _xy[y * _width + x] = pixel;
+        }
+    }
+
+    buildSegments();
+    return valid;
+}
+
+void LedLayout::buildSegments() {
+    uint16_t index = 0;
+
+    for (uint8_t segment = 0; segment < COLORS_COUNT; segment++) {
+        _segment_start[segment] = index;
+
+        if (_height == 1) {
+            // A quarter of the row
+            uint16_t first = (segment * _width) / COLORS_COUNT;
+            uint16_t last  = ((segment + 1) * _width) / COLORS_COUNT;
+            for (uint16_t x = first; x < last; x++) {
+                _order[index++] = _xy[x];
+            }
+            continue;
+        }
+
+        // Quadrants: red top left, green top right, blue bottom left, yellow bottom right
+        uint16_t x0 = (segment & 1) ? _width / 2 : 0;
+        uint16_t x1 = (segment & 1) ? _width : _width / 2;
+        uint16_t y0 = (segment & 2) ? _height / 2 : 0;
+        uint16_t y1 = (segment & 2) ? _height : _height / 2;
+        for (uint16_t y = y0; y < y1; y++) {
+            for (uint16_t x = x0; x < x1; x++) {
+                _order[index++] = pixelAt(x, y);
+            }
+        }
+    }
+    _segment_start[COLORS_COUNT] = index;
+}
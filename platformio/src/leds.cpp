@@ -3,34 +3,64 @@
 
 using namespace simon;
 
-void Leds::showColor(simon::color_t c, unsigned long wait) {
-    int16_t firstPixel = -1;                   // Start at the first pixel
-    uint32_t color     = simon::colorToRGB(c); // Convert color_t to RGB value
+Leds::Leds(Adafruit_NeoPixel& strip, const config_t& config) : _strip(strip), _config(config) {
+    for (led_layer_buffer_t& layer : _layers) {
+        layer.opacity = 255;
+        layer.blend   = BlendAlpha;
+        layer.empty   = false; // Cleared below
+    }
+    clear();
+}
 
-    switch (c) {
-    case color_t::ColorRed:    firstPixel = 0; break;
+void Leds::setBlend(led_layer_t layer, led_blend_t blend, uint8_t opacity) {
+    _layers[layer].blend   = blend;
+    _layers[layer].opacity = opacity;
+    _dirty                 = true;
+}
 
-    case color_t::ColorGreen:  firstPixel = 6; break;
+void Leds::setPixel(led_layer_t layer, uint16_t pixel, uint32_t color, uint8_t alpha) {
+    led_layer_buffer_t& buffer = _layers[layer];
+    uint8_t* rgb               = buffer.rgb + pixel * 3;
 
-    case color_t::ColorBlue:   firstPixel = 12; break;
+    // The background is opaque over black: fade the color itself
+    uint16_t scale = layer == LayerBackground ? alpha + (alpha >> 7) : 256;
 
-    case color_t::ColorYellow: firstPixel = 18; break;
+    rgb[0]              = ((uint8_t)(color >> 16) * scale) >> 8;
+    rgb[1]              = ((uint8_t)(color >> 8) * scale) >> 8;
+    rgb[2]              = ((uint8_t)color * scale) >> 8;
+    buffer.alpha[pixel] = layer == LayerBackground ? 255 : alpha;
+    buffer.empty        = false;
+    _dirty              = true;
+}
 
-    case color_t::ColorNone:
-        firstPixel = -1; // No color, no pixels to show
-        break;
+void Leds::showColor(simon::color_t c, bool animate, led_layer_t layer) {
+    if (c == color_t::ColorNone) {
+        return; // No color, no pixels to show
     }
 
-    if (firstPixel >= 0) {
-        if (wait > 0) {
-            wipe(color, simon::wipe_direction_t::WipeFromCenter, wait, firstPixel, 6);
-        } else {
-            fill(color, firstPixel, 6);
-        }
+    uint32_t color  = simon::colorToRGB(c); // Convert color_t to RGB value
+    uint8_t segment = LedLayout::segmentOf(c);
+
+    if (animate) {
+        wipe(color, simon::wipe_direction_t::WipeFromCenter, segment, layer);
+    } else {
+        setSegment(segment, color, 0, layer);
+    }
+}
+
+void Leds::hideColor(simon::color_t c, led_layer_t layer) {
+    if (c == color_t::ColorNone) {
+        return;
+    }
+
+    uint8_t segment       = LedLayout::segmentOf(c);
+    const uint8_t* pixels = _layout.segment(segment);
+    for (uint16_t i = 0; i < _layout.segmentSize(segment); i++) {
+        setPixel(layer, pixels[i], 0, 0); // Transparent
     }
 }
 
-void Leds::fill(uint32_t color, unsigned int firstPixel, unsigned int count) {
+void Leds::fill(uint32_t color, unsigned int firstPixel, unsigned int count, led_layer_t layer) {
     if (firstPixel >= _strip.numPixels()) {
         Serial.println(F("Error: firstPixel exceeds strip length!"));
         return; // Exit if firstPixel is out of bounds
@@ -40,154 +70,202 @@ void Leds::fill(uint32_t color, unsigned int firstPixel, unsigned int count) {
         count = _strip.numPixels() - firstPixel; // Fill to the end of the strip
     }
 
-    _strip.fill(color, firstPixel, count); // Fill the strip with the specified color
-    show();                                // Update strip to match
+    for (unsigned int i = firstPixel; i < firstPixel + count; i++) {
+        setPixel(layer, i, color);
+    }
 }
 
-void Leds::clear() { _strip.clear(); }
+void Leds::setSegment(uint8_t segment, uint32_t color, uint16_t count, led_layer_t layer) {
+    const uint8_t* pixels = _layout.segment(segment);
+    uint16_t size         = _layout.segmentSize(segment);
 
-void Leds::clearNow() {
-    clear();
-    show();
+    if (count == 0 || count > size) {
+        count = size;
+    }
+    for (uint16_t i = 0; i < count; i++) {
+        setPixel(layer, pixels[i], color);
+    }
 }
 
-void Leds::show() {
-    _strip.show(); // Update strip to match
+void Leds::clear() {
+    for (uint8_t layer = 0; layer < LED_LAYERS_COUNT; layer++) {
+        clear(static_cast<led_layer_t>(layer));
+    }
 }
 
-void Leds::rainbow(unsigned long wait, uint8_t count) {
-    // Hue of first pixel runs 5 complete loops through the color wheel.
-    // Color wheel has a range of 65536 but it's OK if we roll over, so
-    // just count from 0 to 5*65536. Adding 256 to firstPixelHue each time
-    // means we'll make 5*65536/256 = 1280 passes through this loop:
-    for (long firstPixelHue = 0; firstPixelHue < count * 65536; firstPixelHue += 256) {
-        // strip.rainbow() can take a single argument (first pixel hue) or
-        // optionally a few extras: number of rainbow repetitions (default 1),
-        // saturation and value (brightness) (both 0-255, similar to the
-        // ColorHSV() function, default 255), and a true/false flag for whether
-        // to apply gamma correction to provide 'truer' colors (default true).
-        _strip.rainbow(firstPixelHue);
-        // Above line is equivalent to:
-        // strip.rainbow(firstPixelHue, 1, 255, 255, true);
-        _strip.show(); // Update strip with new contents
-        delay(wait);   // Pause for a moment
+void Leds::clear(led_layer_t layer) {
+    led_layer_buffer_t& buffer = _layers[layer];
+    if (!buffer.empty) {
+        memset(buffer.rgb, 0, sizeof(buffer.rgb));
+        memset(buffer.alpha, 0, sizeof(buffer.alpha));
+        buffer.empty = true;
+        _dirty       = true;
     }
 }
 
-void Leds::wipe(uint32_t color,
-                simon::wipe_direction_t direction,
-                unsigned long wait,
-                unsigned int firstPixel,
-                unsigned int count) {
-    switch (direction) {
-    case simon::wipe_direction_t::WipeFromStart:
-        wipeFromStart(color, wait, firstPixel, count);
-        break;
-
-    case simon::wipe_direction_t::WipeFromCenter:
-        wipeFromCenter(color, wait, firstPixel, count);
-        break;
-
-    case simon::wipe_direction_t::WipeFromEdges:
-        wipeFromEdged(color, wait, firstPixel, count);
-        break;
-    }
+void Leds::clearNow() {
+    clear();
+    show();
 }
 
-void Leds::wipeFromStart(uint32_t color,
-                         unsigned long wait,
-                         unsigned int firstPixel,
-                         unsigned int count) {
-    if (firstPixel >= _strip.numPixels()) {
-        Serial.println(F("Error: firstPixel exceeds strip length!"));
-        return; // Exit if firstPixel is out of bounds
-    }
+void Leds::compose() {
+    const uint16_t pixels = min<uint16_t>(_strip.numPixels(), LED_MAX_PIXELS);
+    const uint16_t bytes  = pixels * 3;
 
-    if (firstPixel + count > _strip.numPixels()) {
-        Serial.println(F("Error: firstPixel + count exceeds strip length!"));
-        return; // Exit if count exceeds strip length
-    }
+    // The background is opaque
+    memcpy(_frame, _layers[LayerBackground].rgb, bytes);
 
-    for (int i = firstPixel; i < firstPixel + count; i++) { // For each pixel in strip...
-        _strip.setPixelColor(i, color);                     //  Set pixel's color (in RAM)
+    for (uint8_t l = LayerBackground + 1; l < LED_LAYERS_COUNT; l++) {
+        const led_layer_buffer_t& layer = _layers[l];
+        if (layer.empty || layer.opacity == 0) {
+            continue;
+        }
 
-        if (wait > 0) {
-            show();      //  Update strip to match
-            delay(wait); //  Pause for a moment
+        // Straight loops over the packed bytes, 0..256 weights so that 255 is exact
+        const uint16_t opacity = layer.opacity + (layer.opacity >> 7);
+        const uint8_t* src     = layer.rgb;
+        uint8_t* dst           = _frame;
+
+        if (layer.blend == BlendAdd) {
+            for (uint16_t i = 0; i < pixels; i++, src += 3, dst += 3) {
+                uint16_t a = (layer.alpha[i] * opacity) >> 8;
+                a += a >> 7;
+                for (uint8_t c = 0; c < 3; c++) {
+                    uint16_t value = dst[c] + ((src[c] * a) >> 8);
+                    dst[c]         = value > 255 ? 255 : value;
+                }
+            }
+        } else {
+            for (uint16_t i = 0; i < pixels; i++, src += 3, dst += 3) {
+                uint16_t a = (layer.alpha[i] * opacity) >> 8;
+                a += a >> 7;
+                for (uint8_t c = 0; c < 3; c++) {
+                    dst[c] = (src[c] * a + dst[c] * (256 - a)) >> 8;
+                }
+            }
         }
     }
 
-    if (wait <= 0) {
-        show(); // If no wait, update strip once at the end
+    for (uint16_t i = 0; i < pixels; i++) {
+        _strip.setPixelColor(i, _frame[i * 3], _frame[i * 3 + 1], _frame[i * 3 + 2]);
     }
 }
 
-void Leds::wipeFromCenter(uint32_t color,
-                          unsigned long wait,
-                          unsigned int firstPixel,
-                          unsigned int count) {
-    if (firstPixel >= _strip.numPixels()) {
-        Serial.println(F("Error: firstPixel exceeds strip length!"));
-        return; // Exit if firstPixel is out of bounds
+void Leds::show() {
+    if (!_present || !_dirty) {
+        return; // No strip, or same frame as the last one
     }
+    compose();
+    _strip.show(); // Update strip to match
+    _dirty = false;
+}
 
-    if (firstPixel + count > _strip.numPixels()) {
-        Serial.println(F("Error: firstPixel + count exceeds strip length!"));
-        return; // Exit if count exceeds strip length
-    }
+void Leds::waitFrame(uint32_t start_ms) {
+    uint32_t elapsed = millis() - start_ms;
+    delay(LED_FRAME_MS - elapsed % LED_FRAME_MS);
+}
 
-    auto centerPixel = firstPixel + count / 2 - 1; // Center pixel index
-    // start from the center and move outwards
-    for (int i = 0; i < count / 2; i++) { // For each pixel in strip...
-        if (i == 0) {
-            _strip.setPixelColor(centerPixel, color); // Set center pixel's color (in RAM)
-        } else {
-            _strip.setPixelColor(centerPixel - i, color); // Set pixel's color (in RAM)
-            _strip.setPixelColor(centerPixel + i, color); // Set the opposite pixel
-        }
+uint16_t Leds::rainbowHue(uint32_t elapsed_ms, uint32_t hue_per_s) {
+    // The color wheel rolls over every 65536
+    return ((uint64_t)elapsed_ms * hue_per_s) / 1000;
+}
 
-        if (wait > 0) {
-            show();      //  Update strip to match
-            delay(wait); //  Pause for a moment
-        }
+void Leds::rainbow(uint16_t duration_ms) {
+    uint32_t start = millis();
+    for (uint32_t elapsed = 0; elapsed < duration_ms; elapsed = millis() - start) {
+        rainbowFrame(rainbowHue(elapsed));
+        show();           // Update strip with new contents
+        waitFrame(start); // Pause until the next frame
     }
+}
 
-    if (wait <= 0) {
-        show(); // If no wait, update strip once at the end
+void Leds::rainbowFrame(uint16_t firstPixelHue) {
+    // One turn of the color wheel along the logical pixels, gamma corrected like
+    // Adafruit_NeoPixel::rainbow()
+    const uint32_t pixels = _layout.width() * _layout.height();
+    for (uint16_t y = 0; y < _layout.height(); y++) {
+        for (uint16_t x = 0; x < _layout.width(); x++) {
+            uint16_t hue = firstPixelHue + ((y * _layout.width() + x) * 65536UL) / pixels;
+            setPixel(LayerBackground,
+                     _layout.pixelAt(x, y),
+                     Adafruit_NeoPixel::gamma32(Adafruit_NeoPixel::ColorHSV(hue)));
+        }
     }
 }
 
-void Leds::wipeFromEdged(uint32_t color,
-                         unsigned long wait,
-                         unsigned int firstPixel,
-                         unsigned int count) {
-    if (firstPixel >= _strip.numPixels()) {
-        Serial.println(F("Error: firstPixel exceeds strip length!"));
-        return; // Exit if firstPixel is out of bounds
-    }
+uint16_t Leds::wipeSteps(simon::wipe_direction_t direction, uint16_t count) {
+    // Pixels lit in pairs from the center or from both edges
+    return direction == simon::wipe_direction_t::WipeFromStart ? count : (count + 1) / 2;
+}
 
-    if (firstPixel + count > _strip.numPixels()) {
-        Serial.println(F("Error: firstPixel + count exceeds strip length!"));
-        return; // Exit if count exceeds strip length
+void Leds::wipeFrame(uint32_t color,
+                     simon::wipe_direction_t direction,
+                     uint8_t segment,
+                     uint32_t position,
+                     led_layer_t layer) {
+    if (segment >= COLORS_COUNT) {
+        Serial.println(F("Error: segment exceeds the layout!"));
+        return;
     }
 
-    for (int i = 0; i < count; i++) {                            // For each pixel in strip...
-        _strip.setPixelColor(firstPixel + i, color);             //  Set pixel's color (in RAM)
-        _strip.setPixelColor(firstPixel + count - 1 - i, color); // Set the opposite pixel
+    const uint8_t* pixels = _layout.segment(segment);
+    uint16_t count        = _layout.segmentSize(segment);
+    uint16_t left         = (count - 1) / 2; // Center pixels (the same one for odd counts)
+    uint16_t right        = count / 2;
+
+    for (uint16_t i = 0; i < count; i++) {
+        uint16_t step;
+        switch (direction) {
+        case simon::wipe_direction_t::WipeFromCenter:
+            step = i <= left ? left - i : i - right;
+            break;
+
+        case simon::wipe_direction_t::WipeFromEdges: step = min<uint16_t>(i, count - 1 - i); break;
 
-        if (wait > 0) {
-            show();      //  Update strip to match
-            delay(wait); //  Pause for a moment
+        default:                                     step = i; break;
+        }
+
+        // Fully lit once the wipe is past the step, fading in while it is reached
+        uint32_t start = (uint32_t)step << 8;
+        if (position > start) {
+            setPixel(layer, pixels[i], color, min<uint32_t>(position - start, 255));
         }
     }
+}
 
-    if (wait <= 0) {
-        show(); // If no wait, update strip once at the end
+void Leds::wipe(uint32_t color,
+                simon::wipe_direction_t direction,
+                uint8_t segment,
+                led_layer_t layer) {
+    if (segment >= COLORS_COUNT) {
+        Serial.println(F("Error: segment exceeds the layout!"));
+        return;
+    }
+
+    uint32_t steps       = wipeSteps(direction, _layout.segmentSize(segment));
+    uint32_t duration_ms = (steps * 1000) / LED_WIPE_PIXELS_PER_S;
+    uint32_t start       = millis();
+
+    for (uint32_t elapsed = 0; elapsed < duration_ms; elapsed = millis() - start) {
+        wipeFrame(color, direction, segment, (elapsed * LED_WIPE_PIXELS_PER_S * 256) / 1000, layer);
+        show();           //  Update strip to match
+        waitFrame(start); //  Pause until the next frame
     }
+    wipeFrame(color, direction, segment, steps << 8, layer);
+    show();
+}
+
+bool Leds::setup() {
+    _strip.setPin(_config.led_pin);
+    _strip.updateLength(_config.led_count);
+    bool layout_ok = _layout.build(_config);
+    _strip.begin(); // Initialize the NeoPixel strip
+    clearNow();     // Initialize all pixels to 'off'
+    configure();
+    return layout_ok;
 }
 
-void Leds::setup() {
-    _strip.begin();           // Initialize the NeoPixel strip
-    _strip.show();            // Initialize all pixels to 'off'
-    _strip.setBrightness(50); // Set brightness (0-255)
-}
\ No newline at end of file
+void Leds::configure() {
+    _strip.setBrightness(_config.led_brightness); // Set brightness (0-255)
+    _dirty = true;
+}
@@ -15,20 +15,24 @@
 
 simon::Game game; // Create an instance of the Simon game
 
+uint8_t resetButtonPin = RESET_BUTTON_PIN; // Configured pin, cached for the loop
 
 void setup() {
     // Initialize serial communication for debugging
     Serial.begin(115200);
+#if !FAST_BOOT
     delay(1000);
-
-    // Setup reset button pin
-    pinMode(RESET_BUTTON_PIN, INPUT_PULLUP);
+#endif
 
     // Normal game setup
     if (!game.setup()) {
         Serial.println(F("Game setup failed!"));
         return;
     }
+
+    // Setup reset button pin, from the settings loaded by the game
+    resetButtonPin = game.config().reset_button_pin;
+    pinMode(resetButtonPin, INPUT_PULLUP);
 }
 
 void checkResetButton() {
@@ -39,7 +43,7 @@ void checkResetButton() {
     const unsigned long debounceDelay         = 50;
     const unsigned long longPressDelay        = 7000; // 7 seconds for high score reset
 
-    bool currentButtonState                   = digitalRead(RESET_BUTTON_PIN);
+    bool currentButtonState                   = digitalRead(resetButtonPin);
 
     // Check if button state changed and debounce
     if (currentButtonState != lastButtonState) {
@@ -0,0 +1,24 @@
+#include "melody.h"
+#include "melodies/fra_martino.h"
+#include "melodies/korobeiniki.h"
+#include "melodies/ode_to_joy.h"
+#include "melodies/pacman.h"
+
+namespace simon {
+
+static const melody_t* const MELODIES[MELODIES_COUNT] = {
+    &melodies::PACMAN,
+    &melodies::ODE_TO_JOY,
+    &melodies::KOROBEINIKI,
+    &melodies::FRA_MARTINO,
+};
+
+const melody_t& melody(melody_id_t id) {
+    if (id >= MELODIES_COUNT) {
+        Serial.println(F("Error: invalid melody id!"));
+        return *MELODIES[0];
+    }
+    return *MELODIES[id];
+} // melody
+
+} // namespace simon
@@ -0,0 +1,237 @@
+#include "memory.h"
+#include "fsm.h"
+#include <new>
+
+namespace simon {
+namespace Memory {
+
+static module_usage_t modules[MODULES_COUNT];
+static state_usage_t states[MEMORY_STATES];
+static module_t current_module = ModuleCore;
+static uint8_t current_state   = 0;
+static bool strict             = false;
+static uint32_t total_new      = 0; // Bytes requested through operator new, all modules
+static uint32_t reported       = 0; // Violations already printed
+static portMUX_TYPE lock       = portMUX_INITIALIZER_UNLOCKED;
+
+static_assert(MEMORY_STATES >= Fsm::STATE_TYPES_COUNT, "MEMORY_STATES is too small");
+
+static const char PROGMEM MODULE_NAMES[MODULES_COUNT][8] = {
+    "core", "game", "buttons", "leds", "buzzer", "display", "fsm"};
+
+#if MEMORY_ACCOUNTING
+
+static void countAllocation(counters_t& counters, size_t size) {
+    counters.allocations++;
+    counters.bytes += size;
+    counters.live += size;
+    if (counters.live > static_cast<int32_t>(counters.peak)) {
+        counters.peak = counters.live;
+    }
+}
+
+static void countFree(counters_t& counters, size_t size) {
+    counters.frees++;
+    counters.live -= size;
+}
+
+// Kept in front of every block so delete can account for it
+typedef struct BlockHeader {
+    uint32_t size;
+    uint8_t module;
+    uint8_t state;
+} block_header_t;
+
+#define MEMORY_HEADER __STDCPP_DEFAULT_NEW_ALIGNMENT__ // Keeps the payload aligned
+static_assert(sizeof(block_header_t) <= MEMORY_HEADER, "Block header too large");
+
+static void* allocate(size_t size) {
+    uint8_t* block = static_cast<uint8_t*>(malloc(size + MEMORY_HEADER));
+    if (block == nullptr) {
+        return nullptr;
+    }
+
+    block_header_t* header = reinterpret_cast<block_header_t*>(block);
+
+    portENTER_CRITICAL(&lock);
+    header->size   = size;
+    header->module = current_module;
+    header->state  = current_state;
+    countAllocation(modules[current_module].dynamic, size);
+    countAllocation(states[current_state].dynamic, size);
+    total_new += size;
+    if (strict) {
+        states[current_state].violations++;
+    }
+    portEXIT_CRITICAL(&lock);
+
+    return block + MEMORY_HEADER;
+}
+
+static void release(void* ptr) {
+    if (ptr == nullptr) {
+        return;
+    }
+
+    uint8_t* block               = static_cast<uint8_t*>(ptr) - MEMORY_HEADER;
+    const block_header_t* header = reinterpret_cast<const block_header_t*>(block);
+
+    // Charged back to the module and state that made the allocation
+    portENTER_CRITICAL(&lock);
+    countFree(modules[header->module].dynamic, header->size);
+    countFree(states[header->state].dynamic, header->size);
+    portEXIT_CRITICAL(&lock);
+
+    free(block);
+}
+
+#endif // MEMORY_ACCOUNTING
+
+Scope::Scope(module_t module) :
+    _previous(current_module), _free_heap(ESP.getFreeHeap()), _new_bytes(total_new) {
+    current_module = module;
+}
+
+Scope::~Scope() {
+    // Heap taken by malloc() in the scope, without what operator new already counted
+    int32_t taken = static_cast<int32_t>(_free_heap - ESP.getFreeHeap()) -
+                    static_cast<int32_t>(total_new - _new_bytes);
+    if (taken > 0) {
+        modules[current_module].external_bytes += taken;
+    }
+    current_module = _previous;
+}
+
+void addStatic(module_t module, uint32_t bytes) { modules[module].static_bytes += bytes; }
+
+void setState(uint8_t state, bool is_strict) {
+    sample();
+
+    if (state >= MEMORY_STATES) {
+        state = 0;
+    }
+
+    portENTER_CRITICAL(&lock);
+    current_state = state;
+    strict        = is_strict;
+    portEXIT_CRITICAL(&lock);
+
+    states[state].enter_free = ESP.getFreeHeap();
+}
+
+void sample() {
+    state_usage_t& usage = states[current_state];
+
+    uint32_t free_heap = ESP.getFreeHeap();
+    if (free_heap < usage.enter_free && usage.enter_free - free_heap > usage.heap_drop) {
+        usage.heap_drop = usage.enter_free - free_heap;
+    }
+
+    uint32_t total = violations();
+    if (total != reported) {
+        Serial.print(F("Error: "));
+        Serial.print(total - reported);
+        Serial.print(F(" allocation(s) in allocation-free state "));
+        Serial.println(Fsm::stateTypeToString(static_cast<Fsm::StateType>(current_state)));
+        reported = total;
+    }
+}
+
+const module_usage_t& module(module_t module) { return modules[module]; }
+
+const state_usage_t& state(uint8_t state) { return states[state < MEMORY_STATES ? state : 0]; }
+
+uint32_t violations() {
+    uint32_t total = 0;
+    for (uint8_t i = 0; i < MEMORY_STATES; i++) {
+        total += states[i].violations;
+    }
+    return total;
+}
+
+static void printCounters(const counters_t& counters) {
+    Serial.print(counters.allocations);
+    Serial.print(F(" new / "));
+    Serial.print(counters.frees);
+    Serial.print(F(" delete, "));
+    Serial.print(counters.bytes);
+    Serial.print(F(" B total, live "));
+    Serial.print(counters.live);
+    Serial.print(F(" B, peak "));
+    Serial.print(counters.peak);
+    Serial.print(F(" B"));
+}
+
+void printReport() {
+    Serial.println(F("--- Memory ---"));
+    Serial.print(F("Heap: "));
+    Serial.print(ESP.getFreeHeap());
+    Serial.print(F(" B free of "));
+    Serial.print(ESP.getHeapSize());
+    Serial.print(F(", low-water "));
+    Serial.print(ESP.getMinFreeHeap());
+    Serial.print(F(" B, largest block "));
+    Serial.print(ESP.getMaxAllocHeap());
+    Serial.println(F(" B"));
+
+    for (uint8_t i = 0; i < MODULES_COUNT; i++) {
+        const module_usage_t& usage = modules[i];
+        Serial.print(FPSTR(MODULE_NAMES[i]));
+        Serial.print(F(": static "));
+        Serial.print(usage.static_bytes);
+        Serial.print(F(" B, external "));
+        Serial.print(usage.external_bytes);
+        Serial.print(F(" B, "));
+        printCounters(usage.dynamic);
+        Serial.println();
+    }
+
+    for (uint8_t i = 0; i < Fsm::STATE_TYPES_COUNT; i++) {
+        const state_usage_t& usage = states[i];
+        Serial.print(Fsm::stateTypeToString(static_cast<Fsm::StateType>(i)));
+        Serial.print(F(": "));
+        printCounters(usage.dynamic);
+        Serial.print(F(", heap drop "));
+        Serial.print(usage.heap_drop);
+        Serial.print(F(" B"));
+        if (usage.violations > 0) {
+            Serial.print(F(", VIOLATIONS "));
+            Serial.print(usage.violations);
+        }
+        Serial.println();
+    }
+}
+
+} // namespace Memory
+} // namespace simon
+
+#if MEMORY_ACCOUNTING
+
+// Global allocation operators routed through the accounting
+void* operator new(size_t size) {
+    void* ptr = simon::Memory::allocate(size);
+    if (ptr == nullptr) {
+        abort();
+    }
+    return ptr;
+}
+
+void* operator new[](size_t size) { return operator new(size); }
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+    return simon::Memory::allocate(size);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+    return simon::Memory::allocate(size);
+}
+
+void operator delete(void* ptr) noexcept { simon::Memory::release(ptr); }
+
+void operator delete[](void* ptr) noexcept { simon::Memory::release(ptr); }
+
+void operator delete(void* ptr, size_t) noexcept { simon::Memory::release(ptr); }
+
+void operator delete[](void* ptr, size_t) noexcept { simon::Memory::release(ptr); }
+
+#endif // MEMORY_ACCOUNTING
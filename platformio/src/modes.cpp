@@ -0,0 +1,95 @@
+#include "modes.h"
+
+namespace simon {
+
+const char PROGMEM STR_MODE_CLASSIC[] = "Classico";
+const char PROGMEM STR_MODE_REVERSE[] = "Inverso";
+const char PROGMEM STR_MODE_SPEED[]   = "Veloce";
+const char PROGMEM STR_MODE_RANDOM[]  = "Casuale";
+const char PROGMEM STR_MODE_ADD_ONE[] = "Aggiungi";
+const char PROGMEM STR_MODE_VERSUS[]  = "Sfida";
+
+// -------------------------------------------
+// GameMode
+// -------------------------------------------
+
+bool GameMode::beginRound(Sequence& seq) { return seq.push(next_color()); }
+
+// -------------------------------------------
+// Modes
+// -------------------------------------------
+
+const char* ClassicMode::name() const { return STR_MODE_CLASSIC; }
+
+const char* ReverseMode::name() const { return STR_MODE_REVERSE; }
+
+const char* SpeedMode::name() const { return STR_MODE_SPEED; }
+
+const char* RandomMode::name() const { return STR_MODE_RANDOM; }
+
+bool RandomMode::beginRound(Sequence& seq) {
+    if (seq.full()) {
+        return false;
+    }
+
+    uint8_t length = seq.size() + 1;
+    seq.clear();
+    for (uint8_t i = 0; i < length; i++) {
+        seq.push(next_color());
+    }
+    return true;
+}
+
+const char* AddOneMode::name() const { return STR_MODE_ADD_ONE; }
+
+bool AddOneMode::beginRound(Sequence& seq) {
+    if (seq.empty()) {
+        // The first color is picked by the game
+        return seq.push(next_color());
+    }
+
+    // The next player has to add a color during the round
+    _turn++;
+    return !seq.full();
+}
+
+bool AddOneMode::checkInput(Sequence& seq, uint8_t index, color_t color) {
+    if (index < seq.size()) {
+        return seq[index] == color;
+    }
+
+    // Last input of the round: the player's own color extends the sequence
+    seq.push(color);
+    return true;
+}
+
+#if BUTTON_BANKS_COUNT > 1
+const char* VersusMode::name() const { return STR_MODE_VERSUS; }
+#endif
+
+// -------------------------------------------
+// Registry
+// -------------------------------------------
+
+static ClassicMode classic_mode;
+static ReverseMode reverse_mode;
+static SpeedMode speed_mode;
+static RandomMode random_mode;
+static AddOneMode add_one_mode;
+#if BUTTON_BANKS_COUNT > 1
+static VersusMode versus_mode;
+#endif
+
+static GameMode* const game_modes[GAME_MODES_COUNT] = {&classic_mode,
+                                                       &reverse_mode,
+                                                       &speed_mode,
+                                                       &random_mode,
+                                                       &add_one_mode,
+#if BUTTON_BANKS_COUNT > 1
+                                                       &versus_mode
+#endif
+};
+
+GameMode& gameMode(uint8_t index) { return *game_modes[index % GAME_MODES_COUNT]; }
+
+} // namespace simon
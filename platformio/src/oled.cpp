@@ -0,0 +1,275 @@
+#include "oled.h"
+#include "supervisor.h"
+
+using namespace simon;
+
+// Contrast of Adafruit_SSD1306::dim() with SSD1306_SWITCHCAPVCC
+#define OLED_CONTRAST     0xCF
+#define OLED_CONTRAST_DIM 0x00
+
+/**
+ * @brief Holds the bus mutex for a scope (nothing to hold before Oled::begin()).
+ */
+class BusLock {
+  private:
+    SemaphoreHandle_t _mutex;
+
+  public:
+    BusLock(SemaphoreHandle_t mutex) : _mutex(mutex) {
+        if (_mutex != nullptr) {
+            xSemaphoreTake(_mutex, portMAX_DELAY);
+        }
+    }
+
+    ~BusLock() {
+        if (_mutex != nullptr) {
+            xSemaphoreGive(_mutex);
+        }
+    }
+};
+
+void Oled::begin() {
+    _wire.setClock(OLED_I2C_CLOCK);
+    _wire.setTimeOut(OLED_I2C_TIMEOUT_MS);
+
+    // Also called by the bus recovery
+    if (_bus == nullptr) {
+        _bus = xSemaphoreCreateMutex();
+        if (_bus == nullptr) {
+            Serial.println(F("Error: failed to create display bus mutex!"));
+        }
+    }
+}
+
+uint8_t Oled::command(const uint8_t* commands, uint8_t count) {
+    _wire.beginTransmission(_address);
+    _wire.write(static_cast<uint8_t>(0x00)); // Co = 0, D/C = 0: commands follow
+    _wire.write(commands, count);
+    return _wire.endTransmission();
+}
+
+uint8_t Oled::sendState() {
+    const uint8_t state[] = {static_cast<uint8_t>(_on ? SSD1306_DISPLAYON : SSD1306_DISPLAYOFF),
+                             SSD1306_SETCONTRAST,
+                             static_cast<uint8_t>(_dimmed ? OLED_CONTRAST_DIM : OLED_CONTRAST)};
+    return command(state, sizeof(state));
+}
+
+uint8_t Oled::transfer(const uint8_t* buffer,
+                       uint8_t first_page,
+                       uint8_t last_page,
+                       uint8_t first_column,
+                       uint8_t last_column) {
+    // Restrict the controller's addressing window (horizontal addressing mode)
+    const uint8_t window[] = {SSD1306_PAGEADDR,
+                              first_page,
+                              last_page,
+                              SSD1306_COLUMNADDR,
+                              first_column,
+                              last_column};
+
+    uint8_t error = command(window, sizeof(window));
+    if (error != 0) {
+        return error;
+    }
+
+    uint8_t width = last_column - first_column + 1;
+
+    for (uint8_t page = first_page; page <= last_page; page++) {
+        const uint8_t* data = buffer + page * SCREEN_WIDTH + first_column;
+        uint8_t remaining   = width;
+
+        while (remaining > 0) {
+            uint8_t chunk = min<uint8_t>(remaining, OLED_I2C_CHUNK);
+
+            _wire.beginTransmission(_address);
+            _wire.write(static_cast<uint8_t>(0x40)); // Co = 0, D/C = 1: data follows
+            _wire.write(data, chunk);
+            error = _wire.endTransmission();
+            if (error != 0) {
+                return error;
+            }
+
+            data += chunk;
+            remaining -= chunk;
+        }
+    }
+    return 0;
+}
+
+void Oled::recoverBus() {
+    _wire.end();
+
+    pinMode(OLED_SDA_PIN, INPUT_PULLUP);
+    pinMode(OLED_SCL_PIN, OUTPUT_OPEN_DRAIN);
+    digitalWrite(OLED_SCL_PIN, HIGH);
+    delayMicroseconds(5);
+
+    if (digitalRead(OLED_SDA_PIN) == LOW) {
+        _stats.recoveries++;
+
+        // Up to 9 clocks let the display finish the byte it is sending and release SDA
+        for (uint8_t i = 0; i < 9 && digitalRead(OLED_SDA_PIN) == LOW; i++) {
+            digitalWrite(OLED_SCL_PIN, LOW);
+            delayMicroseconds(5);
+            digitalWrite(OLED_SCL_PIN, HIGH);
+            delayMicroseconds(5);
+        }
+    }
+
+    // STOP: SDA rises while SCL is high
+    pinMode(OLED_SDA_PIN, OUTPUT_OPEN_DRAIN);
+    digitalWrite(OLED_SDA_PIN, LOW);
+    delayMicroseconds(5);
+    digitalWrite(OLED_SDA_PIN, HIGH);
+    delayMicroseconds(5);
+
+    _wire.begin(OLED_SDA_PIN, OLED_SCL_PIN);
+    begin();
+}
+
+bool Oled::available() {
+    if (_cooldown && millis() - _cooldown_start_ms >= OLED_I2C_COOLDOWN_MS) {
+        _cooldown = false;
+        _failures = 0;
+        Serial.println(F("Display bus: cooldown over, retrying"));
+    }
+    return !_cooldown;
+}
+
+bool Oled::retry(uint8_t error, uint8_t attempt) {
+    _stats.errors++;
+    _stats.last_error = error;
+    if (attempt >= OLED_I2C_RETRIES) {
+        return false;
+    }
+
+    _stats.retries++;
+    recoverBus();
+    delay(OLED_I2C_BACKOFF_MS << attempt);
+    return true;
+}
+
+void Oled::drop() {
+    _stats.dropped++;
+    _resync = true;
+
+    if (++_failures >= OLED_I2C_FAIL_LIMIT) {
+        _stats.cooldowns++;
+        _cooldown          = true;
+        _cooldown_start_ms = millis();
+        Serial.println(F("Error: display bus keeps failing, display paused!"));
+    }
+}
+
+void Oled::sendCommands(const uint8_t* commands, uint8_t count) {
+    if (!_present || _display.getBuffer() == nullptr) {
+        return; // Display absent or not initialized
+    }
+    if (!available()) {
+        _resync = true; // Sent with the first flush after the cooldown
+        return;
+    }
+    Supervisor::Scope scope(Supervisor::ScopeDisplay);
+
+    for (uint8_t attempt = 0;; attempt++) {
+        uint8_t error = command(commands, count);
+        if (error == 0) {
+            _failures = 0;
+            return;
+        }
+        if (!retry(error, attempt)) {
+            break;
+        }
+    }
+    drop();
+}
+
+void Oled::dim(bool dim) {
+    BusLock lock(_bus);
+    _dimmed                  = dim;
+    const uint8_t contrast[] = {SSD1306_SETCONTRAST,
+                                static_cast<uint8_t>(dim ? OLED_CONTRAST_DIM : OLED_CONTRAST)};
+    sendCommands(contrast, sizeof(contrast));
+}
+
+void Oled::power(bool on) {
+    BusLock lock(_bus);
+    _on                   = on;
+    const uint8_t panel[] = {static_cast<uint8_t>(on ? SSD1306_DISPLAYON : SSD1306_DISPLAYOFF)};
+    sendCommands(panel, sizeof(panel));
+}
+
+void Oled::flushBuffer(const uint8_t* buffer,
+                       uint8_t first_page,
+                       uint8_t last_page,
+                       uint8_t first_column,
+                       uint8_t last_column) {
+    if (!_present || buffer == nullptr || _display.getBuffer() == nullptr) {
+        return; // Display absent or not initialized
+    }
+
+    BusLock lock(_bus);
+    if (!available()) {
+        return; // The bus keeps failing, try again after the cooldown
+    }
+    Supervisor::Scope scope(Supervisor::ScopeDisplay);
+
+    bool resync = _resync;
+    if (resync) {
+        // A previous transfer was lost, the whole screen and the panel state may be stale
+        first_page   = 0;
+        last_page    = SCREEN_HEIGHT / 8 - 1;
+        first_column = 0;
+        last_column  = SCREEN_WIDTH - 1;
+    }
+
+    for (uint8_t attempt = 0;; attempt++) {
+        uint8_t error = resync ? sendState() : 0;
+        if (error == 0) {
+            error = transfer(buffer, first_page, last_page, first_column, last_column);
+        }
+        if (error == 0) {
+            _stats.transfers++;
+            _resync   = false;
+            _failures = 0;
+            return;
+        }
+        if (!retry(error, attempt)) {
+            break;
+        }
+    }
+    drop();
+}
+
+oled_bus_stats_t Oled::stats() const {
+    BusLock lock(_bus);
+    return _stats;
+}
+
+void Oled::printReport() const {
+    oled_bus_stats_t stats;
+    bool cooldown;
+    {
+        BusLock lock(_bus);
+        stats    = _stats;
+        cooldown = _cooldown;
+    }
+
+    Serial.print(F("Display bus: "));
+    Serial.print(stats.transfers);
+    Serial.print(F(" flushes, "));
+    Serial.print(stats.errors);
+    Serial.print(F(" errors (last "));
+    Serial.print(stats.last_error);
+    Serial.print(F("), "));
+    Serial.print(stats.retries);
+    Serial.print(F(" retries, "));
+    Serial.print(stats.recoveries);
+    Serial.print(F(" stuck SDA, "));
+    Serial.print(stats.dropped);
+    Serial.print(F(" dropped, "));
+    Serial.print(stats.cooldowns);
+    Serial.print(F(" cooldowns"));
+    Serial.println(cooldown ? F(" (paused)") : F(""));
+}
@@ -0,0 +1,135 @@
+#include "particles.h"
+
+using namespace simon;
+
+#define PARTICLE_ONE (1 << PARTICLE_SHIFT)
+
+// Unit vectors of 16 evenly spaced directions, fixed point (x = cos, y = sin = cos shifted by 4)
+static const int8_t PROGMEM DIRECTIONS[16] = {
+    16, 15, 11, 6, 0, -6, -11, -15, -16, -15, -11, -6, 0, 6, 11, 15};
+
+void ParticleSystem::clear() {
+    for (uint8_t i = 0; i < PARTICLE_POOL_SIZE; i++) {
+        _pool[i].life = 0;
+    }
+    _alive   = 0;
+    _free    = 0;
+    _dropped = 0;
+    _frame   = 0;
+}
+
+bool ParticleSystem::emit(
+    particle_type_t type, int16_t x, int16_t y, int8_t vx, int8_t vy, uint8_t life) {
+    if (life == 0) {
+        return false;
+    }
+
+    for (uint8_t n = 0; n < PARTICLE_POOL_SIZE; n++) {
+        uint8_t i = (_free + n) % PARTICLE_POOL_SIZE;
+        if (_pool[i].life == 0) {
+            _pool[i] = {static_cast<int16_t>(x * PARTICLE_ONE),
+                        static_cast<int16_t>(y * PARTICLE_ONE),
+                        vx,
+                        vy,
+                        life,
+                        static_cast<uint8_t>(type)};
+            _free = (i + 1) % PARTICLE_POOL_SIZE;
+            _alive++;
+            return true;
+        }
+    }
+
+    _dropped++;
+    return false;
+}
+
+uint8_t ParticleSystem::burst(int16_t x, int16_t y, uint8_t count, uint8_t speed, uint8_t life) {
+    uint8_t emitted = 0;
+    uint8_t offset  = random(0, 16); // Rotate the pattern so bursts do not look identical
+
+    for (uint8_t n = 0; n < count; n++) {
+        uint8_t dir = (offset + (n * 16) / count) % 16;
+        int8_t dx   = pgm_read_byte(&DIRECTIONS[dir]);
+        int8_t dy   = pgm_read_byte(&DIRECTIONS[(dir + 12) % 16]);
+
+        // Slightly different lifetimes make the burst fade out gradually
+        uint8_t jitter = random(0, life / 4 + 1);
+        if (emit(ParticleSpark, x, y, (dx * speed) / 16, (dy * speed) / 16, life - jitter)) {
+            emitted++;
+        }
+    }
+    return emitted;
+}
+
+bool ParticleSystem::launch(int16_t x, int16_t apex_y) {
+    // Constant speed climb from the bottom edge to the apex
+    int16_t distance = SCREEN_HEIGHT - apex_y;
+    uint8_t life     = constrain(distance / PARTICLE_ROCKET_SPEED, 1, 255);
+    int8_t vy        = -PARTICLE_ROCKET_SPEED * PARTICLE_ONE;
+    return emit(ParticleRocket, x, SCREEN_HEIGHT - 1, 0, vy, life);
+}
+
+void ParticleSystem::sparkle(uint8_t count, uint8_t life) {
+    for (uint8_t n = 0; n < count; n++) {
+        emit(ParticleSparkle, random(0, SCREEN_WIDTH), random(0, SCREEN_HEIGHT), 0, 0, life);
+    }
+}
+
+void ParticleSystem::update() {
+    _frame++;
+
+    for (uint8_t i = 0; i < PARTICLE_POOL_SIZE; i++) {
+        particle_t& p = _pool[i];
+        if (p.life == 0) {
+            continue;
+        }
+
+        p.x += p.vx;
+        p.y += p.vy;
+        if (p.type == ParticleSpark) {
+            p.vy = min<int16_t>(p.vy + PARTICLE_GRAVITY, 127);
+        }
+
+        if (--p.life > 0) {
+            continue;
+        }
+
+        _alive--;
+        if (i < _free) {
+            _free = i;
+        }
+
+        if (p.type == ParticleRocket) {
+            burst(p.x >> PARTICLE_SHIFT,
+                  p.y >> PARTICLE_SHIFT,
+                  PARTICLE_BURST_SPARKS,
+                  PARTICLE_BURST_SPEED,
+                  PARTICLE_BURST_LIFE);
+        }
+    }
+}
+
+void ParticleSystem::draw(uint8_t* buffer) const {
+    for (uint8_t i = 0; i < PARTICLE_POOL_SIZE; i++) {
+        const particle_t& p = _pool[i];
+        if (p.life == 0) {
+            continue;
+        }
+
+        // Dying sparks flicker, sparkles twinkle
+        if (p.type == ParticleSpark && p.life < 4 && ((_frame + i) & 1)) {
+            continue;
+        }
+        if (p.type == ParticleSparkle && ((_frame + i) & 2)) {
+            continue;
+        }
+
+        int16_t x = p.x >> PARTICLE_SHIFT;
+        int16_t y = p.y >> PARTICLE_SHIFT;
+        if (x < 0 || x >= SCREEN_WIDTH || y < 0 || y >= SCREEN_HEIGHT) {
+            continue;
+        }
+
+        buffer[x + (y / 8) * SCREEN_WIDTH] |= 1 << (y & 7);
+    }
+}
@@ -0,0 +1,169 @@
+#include "power.h"
+#include <driver/gpio.h>
+#include <esp_sleep.h>
+
+using namespace simon;
+
+Power::Power() {
+    for (uint8_t i = 0; i < POWER_STATES; i++) {
+        _residency_ms[i] = 0;
+    }
+}
+
+void Power::begin() {
+    _cpu_mhz        = getCpuFrequencyMhz();
+    _state_since_ms = millis();
+}
+
+bool Power::addWakePin(uint8_t pin) {
+    if (_wake_count >= POWER_MAX_WAKE_PINS) {
+        Serial.println(F("Error: too many wake pins!"));
+        return false;
+    }
+
+    // Keep the pull-up of the pin during light sleep
+    gpio_sleep_sel_dis((gpio_num_t)digitalPinToGPIONumber(pin));
+
+    _wake_pins[_wake_count++] = pin;
+    return true;
+}
+
+bool Power::armWakePins() {
+    _wake_armed = 0;
+
+    // A pin that is already low (button held or stuck) would wake the chip up at once
+    for (uint8_t i = 0; i < _wake_count; i++) {
+        gpio_num_t gpio = (gpio_num_t)digitalPinToGPIONumber(_wake_pins[i]);
+        if (digitalRead(_wake_pins[i]) == LOW) {
+            gpio_wakeup_disable(gpio);
+        } else if (gpio_wakeup_enable(gpio, GPIO_INTR_LOW_LEVEL) == ESP_OK) {
+            _wake_armed |= 1 << i;
+        }
+    }
+    return _wake_armed != 0;
+}
+
+void Power::enterState(power_state_t state) {
+    uint32_t now_ms = millis();
+    _residency_ms[_state] += now_ms - _state_since_ms;
+    _state_since_ms = now_ms;
+    _state          = state;
+}
+
+int8_t Power::activeWakePin() const {
+    for (uint8_t i = 0; i < _wake_count; i++) {
+        if ((_wake_armed & (1 << i)) && digitalRead(_wake_pins[i]) == LOW) {
+            return _wake_pins[i];
+        }
+    }
+    return -1;
+}
+
+void Power::dim() {
+    if (_state != PowerAwake) {
+        return;
+    }
+
+    enterState(PowerDimmed);
+    setCpuFrequencyMhz(POWER_IDLE_CPU_MHZ);
+}
+
+uint32_t Power::sleep() {
+    if (!armWakePins()) {
+        Serial.println(F("Error: no wake-up pin available, not sleeping!"));
+        return 0;
+    }
+
+    enterState(PowerAsleep);
+    Serial.println(F("Entering light sleep..."));
+    Serial.flush();
+
+    uint32_t start_ms = millis();
+    esp_sleep_enable_gpio_wakeup();
+
+    // Woken up by anything else than a button (nothing else is enabled, but be safe)
+    do {
+        esp_light_sleep_start();
+        _wake_pin = activeWakePin();
+    } while (_wake_pin < 0);
+
+    _wakeups++;
+    return millis() - start_ms;
+}
+
+void Power::wake() {
+    if (_state == PowerAwake) {
+        return;
+    }
+
+    enterState(PowerAwake);
+    setCpuFrequencyMhz(_cpu_mhz);
+
+    _wake_us      = micros();
+    _wake_pending = true;
+}
+
+void Power::frameShown() {
+    if (!_wake_pending) {
+        return;
+    }
+
+    _wake_pending = false;
+    _wake_last_us = micros() - _wake_us;
+    _wake_max_us  = max(_wake_max_us, _wake_last_us);
+
+    if (_wake_last_us > POWER_WAKE_TARGET_MS * 1000UL) {
+        Serial.print(F("Warning: wake-up to first frame took "));
+        Serial.print(_wake_last_us / 1000);
+        Serial.println(F(" ms"));
+    }
+}
+
+void Power::printReport() {
+    // Include the time spent in the current state so far
+    uint32_t residency[POWER_STATES];
+    uint32_t total_ms = 0;
+    for (uint8_t i = 0; i < POWER_STATES; i++) {
+        residency[i] = _residency_ms[i] + (i == _state ? millis() - _state_since_ms : 0);
+        total_ms += residency[i];
+    }
+
+    // Estimated from the time spent in every state, in tenths of mA
+    static const uint16_t current_ma[POWER_STATES] = {
+        POWER_AWAKE_MA,
+        POWER_DIMMED_MA,
+        POWER_ASLEEP_MA,
+    };
+    uint64_t charge = 0;
+    for (uint8_t i = 0; i < POWER_STATES; i++) {
+        charge += (uint64_t)residency[i] * current_ma[i] * 10;
+    }
+
+    Serial.println(F("--- Power ---"));
+    Serial.print(F("Awake: "));
+    Serial.print(residency[PowerAwake] / 1000);
+    Serial.print(F(" s, dimmed: "));
+    Serial.print(residency[PowerDimmed] / 1000);
+    Serial.print(F(" s, asleep: "));
+    Serial.print(residency[PowerAsleep] / 1000);
+    Serial.println(F(" s"));
+
+    if (total_ms > 0) {
+        uint32_t average = charge / total_ms;
+        Serial.print(F("Estimated average current: "));
+        Serial.print(average / 10);
+        Serial.print('.');
+        Serial.print(average % 10);
+        Serial.println(F(" mA"));
+    }
+
+    Serial.print(F("Wake-ups: "));
+    Serial.print(_wakeups);
+    Serial.print(F(", first frame after "));
+    Serial.print(_wake_last_us / 1000);
+    Serial.print(F(" ms (max "));
+    Serial.print(_wake_max_us / 1000);
+    Serial.print(F(" ms, target "));
+    Serial.print(POWER_WAKE_TARGET_MS);
+    Serial.println(F(" ms)"));
+}
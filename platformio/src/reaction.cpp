@@ -0,0 +1,93 @@
+#include "reaction.h"
+
+using namespace simon;
+
+// -------------------------------------------
+// LatencyStats
+// -------------------------------------------
+
+void LatencyStats::reset() {
+    memset(_buckets, 0, sizeof(_buckets));
+    _count  = 0;
+    _min_us = UINT32_MAX;
+}
+
+void LatencyStats::add(uint32_t latency_us) {
+    uint32_t bucket = latency_us / (REACTION_BUCKET_MS * 1000UL);
+    if (bucket >= REACTION_BUCKETS) {
+        bucket = REACTION_BUCKETS - 1; // Overflow bucket
+    }
+
+    if (_buckets[bucket] < UINT16_MAX) {
+        _buckets[bucket]++;
+    }
+
+    if (latency_us < _min_us) {
+        _min_us = latency_us;
+    }
+    _count++;
+}
+
+uint32_t LatencyStats::percentile(uint8_t percent) const {
+    if (_count == 0) {
+        return 0;
+    }
+
+    // Rank of the requested sample (1-based, rounded up)
+    uint32_t rank       = (_count * percent + 99) / 100;
+    uint32_t cumulative = 0;
+
+    for (uint16_t i = 0; i < REACTION_BUCKETS; i++) {
+        cumulative += _buckets[i];
+        if (cumulative >= rank) {
+            // Report the middle of the bucket
+            return i * REACTION_BUCKET_MS + REACTION_BUCKET_MS / 2;
+        }
+    }
+    return IN_SEQUENCE_TIMEOUT;
+}
+
+// -------------------------------------------
+// ReactionTimer
+// -------------------------------------------
+
+void ReactionTimer::beginRound(uint32_t now_us) {
+    _count          = 0;
+    _round_start_us = now_us;
+}
+
+void ReactionTimer::recordPress(uint32_t at_us) {
+    if (_count >= MAX_SEQUENCE_LENGTH) {
+        return;
+    }
+    _samples[_count].pressed_at  = at_us;
+    _samples[_count].released_at = 0;
+    _count++;
+}
+
+void ReactionTimer::recordRelease(uint32_t at_us) {
+    if (_count == 0) {
+        return;
+    }
+    _samples[_count - 1].released_at = at_us;
+}
+
+uint32_t ReactionTimer::latencyUs(uint8_t index) const {
+    uint32_t reference = _round_start_us;
+    if (index > 0) {
+        // A press without a release (missed edge) counts from its press edge instead
+        const input_sample_t& previous = _samples[index - 1];
+        reference = previous.released_at != 0 ? previous.released_at : previous.pressed_at;
+    }
+
+    // Signed difference keeps this correct across the micros() rollover, and
+    // clamps presses that started before the reference (e.g. held during playback)
+    int32_t latency = static_cast<int32_t>(_samples[index].pressed_at - reference);
+    return latency > 0 ? static_cast<uint32_t>(latency) : 0;
+}
+
+void ReactionTimer::commit(LatencyStats& stats) const {
+    for (uint8_t i = 0; i < _count; i++) {
+        stats.add(latencyUs(i));
+    }
+}
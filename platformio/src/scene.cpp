@@ -0,0 +1,231 @@
+#include "scene.h"
+
+using namespace simon;
+
+#define SCENE_PAGES (SCREEN_HEIGHT / 8)
+
+// Glyph cell of the built-in 5x7 font, including spacing
+#define GLYPH_WIDTH 6
+
+void Scene::reset() {
+    _count = 0;
+
+    // Everything is dirty: the next render starts from a blank screen
+    for (uint8_t page = 0; page < SCENE_PAGES; page++) {
+        _dirty_min[page] = 0;
+        _dirty_max[page] = SCREEN_WIDTH - 1;
+    }
+    _clear = true;
+}
+
+int8_t Scene::addWidget(const widget_t& widget) {
+    if (_count >= SCENE_MAX_WIDGETS) {
+        Serial.println(F("Error: too many widgets in scene!"));
+        return -1;
+    }
+
+    _widgets[_count]       = widget;
+    _widgets[_count].dirty = true;
+    return _count++;
+}
+
+int8_t Scene::addText(const char* str, int16_t x, uint8_t page) {
+    widget_t widget = {};
+    widget.type     = WidgetText;
+    widget.x        = x;
+    widget.page     = page;
+    widget.text     = str;
+    return addWidget(widget);
+}
+
+int8_t Scene::addNumber(uint32_t value, int16_t x, uint8_t page) {
+    widget_t widget = {};
+    widget.type     = WidgetNumber;
+    widget.x        = x;
+    widget.page     = page;
+    widget.number   = value;
+    return addWidget(widget);
+}
+
+int8_t
+Scene::addBitmap(const uint8_t* bitmap, uint8_t width, uint8_t pages, int16_t x, uint8_t page) {
+    widget_t widget = {};
+    widget.type     = WidgetBitmap;
+    widget.x        = x;
+    widget.page     = page;
+    widget.width    = width;
+    widget.pages    = pages;
+    widget.bitmap   = bitmap;
+    return addWidget(widget);
+}
+
+int8_t Scene::addAnimation(const uint8_t* frames,
+                           uint8_t count,
+                           uint16_t period_ms,
+                           uint8_t width,
+                           uint8_t pages,
+                           int16_t x,
+                           uint8_t page) {
+    widget_t widget  = {};
+    widget.type      = WidgetAnimation;
+    widget.x         = x;
+    widget.page      = page;
+    widget.width     = width;
+    widget.pages     = pages;
+    widget.bitmap    = frames;
+    widget.frames    = count;
+    widget.period_ms = period_ms;
+    return addWidget(widget);
+}
+
+void Scene::setText(int8_t id, const char* str) {
+    if (id < 0 || id >= _count || _widgets[id].text == str) {
+        return;
+    }
+    _widgets[id].text  = str;
+    _widgets[id].dirty = true;
+}
+
+void Scene::setNumber(int8_t id, uint32_t value) {
+    if (id < 0 || id >= _count || _widgets[id].number == value) {
+        return;
+    }
+    _widgets[id].number = value;
+    _widgets[id].dirty  = true;
+}
+
+void Scene::markDirty(uint8_t page, uint8_t pages, uint8_t x, uint8_t width) {
+    if (width == 0) {
+        return;
+    }
+
+    uint8_t last = x + width - 1;
+    for (uint8_t p = page; p < page + pages && p < SCENE_PAGES; p++) {
+        if (_dirty_min[p] > _dirty_max[p]) {
+            _dirty_min[p] = x;
+            _dirty_max[p] = last;
+        } else {
+            _dirty_min[p] = min(_dirty_min[p], x);
+            _dirty_max[p] = max(_dirty_max[p], last);
+        }
+    }
+}
+
+void Scene::rasterize(Adafruit_SSD1306& display, const TextCache& text, widget_t& widget) {
+    uint8_t* buffer = display.getBuffer();
+    uint8_t pages   = widget.pages;
+    uint16_t width  = widget.width;
+
+    // Size of the new content
+    switch (widget.type) {
+    case WidgetText: {
+        // Long strings wrap onto the next pages, cached or not
+        uint8_t text_width;
+        text.measure(widget.text, text_width, pages);
+        width = text_width;
+        break;
+    }
+
+    case WidgetNumber: {
+        uint8_t digits = 1;
+        for (uint32_t n = widget.number; n >= 10; n /= 10) {
+            digits++;
+        }
+        width = digits * GLYPH_WIDTH * text.textSize();
+        pages = text.textSize();
+        break;
+    }
+
+    default: break;
+    }
+
+    width     = min<uint16_t>(width, SCREEN_WIDTH);
+    int16_t x = widget.x < 0 ? (SCREEN_WIDTH - width) / 2 : min<int16_t>(widget.x, SCREEN_WIDTH);
+    width     = min<uint16_t>(width, SCREEN_WIDTH - x);
+    pages     = min<uint8_t>(pages, SCENE_PAGES - widget.page);
+
+    // Erase what was drawn before
+    for (uint8_t p = 0; p < widget.drawn_pages; p++) {
+        memset(buffer + (widget.page + p) * SCREEN_WIDTH + widget.drawn_x, 0, widget.drawn_width);
+    }
+    markDirty(widget.page, widget.drawn_pages, widget.drawn_x, widget.drawn_width);
+
+    switch (widget.type) {
+    case WidgetText: text.draw(display, widget.text, x, widget.page); break;
+
+    case WidgetNumber:
+        display.setTextSize(text.textSize());
+        display.setCursor(x, widget.page * 8);
+        display.print(widget.number);
+        break;
+
+    case WidgetBitmap:
+    case WidgetAnimation: {
+        const uint8_t* bitmap = widget.bitmap + widget.frame * widget.width * widget.pages;
+        for (uint8_t p = 0; p < pages; p++) {
+            memcpy(buffer + (widget.page + p) * SCREEN_WIDTH + x, bitmap + p * widget.width, width);
+        }
+        break;
+    }
+    }
+
+    widget.drawn_x     = x;
+    widget.drawn_width = width;
+    widget.drawn_pages = pages;
+    widget.dirty       = false;
+    markDirty(widget.page, pages, x, width);
+}
+
+bool Scene::render(Adafruit_SSD1306& display, Oled& oled, const TextCache& text, uint32_t now_ms) {
+    if (!oled.present() || display.getBuffer() == nullptr) {
+        return false; // Display absent or not initialized, nothing to rasterize
+    }
+
+    if (_clear) {
+        display.clearDisplay();
+        _clear = false;
+    }
+
+    for (uint8_t i = 0; i < _count; i++) {
+        widget_t& widget = _widgets[i];
+
+        if (widget.type == WidgetAnimation && widget.frames > 0) {
+            uint8_t frame = (now_ms / widget.period_ms) % widget.frames;
+            if (frame != widget.frame) {
+                widget.frame = frame;
+                widget.dirty = true;
+            }
+        }
+
+        if (widget.dirty) {
+            rasterize(display, text, widget);
+        }
+    }
+
+    // Flush the dirty areas, merging consecutive pages with the same column range
+    bool flushed = false;
+    uint8_t page = 0;
+    while (page < SCENE_PAGES) {
+        if (_dirty_min[page] > _dirty_max[page]) {
+            page++;
+            continue;
+        }
+
+        uint8_t last = page;
+        while (last + 1 < SCENE_PAGES && _dirty_min[last + 1] == _dirty_min[page] &&
+               _dirty_max[last + 1] == _dirty_max[page]) {
+            last++;
+        }
+
+        oled.flushWindow(page, last, _dirty_min[page], _dirty_max[page]);
+        flushed = true;
+
+        for (uint8_t p = page; p <= last; p++) {
+            _dirty_min[p] = 1;
+            _dirty_max[p] = 0; // Clean
+        }
+        page = last + 1;
+    }
+
+    return flushed;
+}
@@ -0,0 +1,158 @@
+#include "settings.h"
+#include "supervisor.h"
+#include <Preferences.h>
+
+namespace simon {
+namespace Settings {
+
+#define SETTINGS_NAMESPACE   "simon_cfg"
+#define SETTINGS_BUTTONS_KEY "buttons"
+#define SETTINGS_MAX_PIN     48
+
+static const field_t FIELDS[] = {
+    {"led_pin", &Config::led_pin, 0, SETTINGS_MAX_PIN, true},
+    {"led_count", &Config::led_count, 1, LED_MAX_PIXELS, true},
+    {"led_layout", &Config::led_layout, LED_LAYOUT_STRIP, LED_LAYOUT_SERPENTINE, true},
+    {"led_width", &Config::led_width, 1, LED_MAX_PIXELS, true},
+    {"led_offset", &Config::led_offset, 0, LED_MAX_PIXELS - 1, true},
+    {"buzzer_pin", &Config::buzzer_pin, 0, SETTINGS_MAX_PIN, true},
+    {"reset_pin", &Config::reset_button_pin, 0, SETTINGS_MAX_PIN, true},
+    {"brightness", &Config::led_brightness, 1, 255, false},
+    {"volume", &Config::volume, 0, 255, false},
+    {"success_tone", &Config::success_tone_ms, 10, 1000, false},
+    {"debounce", &Config::debounce_ms, 0, 500, false},
+    {"timeout", &Config::input_timeout_ms, 500, 60000, false},
+    {"mode_hold", &Config::mode_select_hold_ms, 200, 5000, false},
+    {"idle_page", &Config::idle_page_ms, 1000, 60000, false},
+    {"idle_rainbow", &Config::idle_rainbow_ms, 1000, 60000, false},
+    {"dim_s", &Config::power_dim_s, 5, 3600, false},
+    {"sleep_s", &Config::power_sleep_s, 10, 36000, false},
+};
+
+static const uint8_t FIELDS_COUNT = sizeof(FIELDS) / sizeof(FIELDS[0]);
+
+config_t defaults() {
+    static const int8_t pins[BUTTON_BANKS_COUNT][COLORS_COUNT] = BUTTON_BANKS_PINS;
+
+    config_t config;
+    config.led_pin             = LED_PIN;
+    config.led_count           = LED_COUNT;
+    config.led_layout          = LED_LAYOUT;
+    config.led_width           = LED_WIDTH;
+    config.led_offset          = LED_RING_OFFSET;
+    config.buzzer_pin          = BUZZER_PIN;
+    config.reset_button_pin    = RESET_BUTTON_PIN;
+    config.led_brightness      = LED_BRIGHTNESS;
+    config.volume              = SYNTH_DEFAULT_VOLUME;
+    config.success_tone_ms     = SUCCESS_TONE_DURATION;
+    config.debounce_ms         = BUTTONS_DEBOUNCE_DELAY;
+    config.input_timeout_ms    = IN_SEQUENCE_TIMEOUT;
+    config.mode_select_hold_ms = MODE_SELECT_HOLD_MS;
+    config.idle_page_ms        = IDLE_PAGE_MS;
+    config.idle_rainbow_ms     = IDLE_RAINBOW_MS;
+    config.power_dim_s         = POWER_DIM_MS / 1000;
+    config.power_sleep_s       = POWER_SLEEP_MS / 1000;
+    memcpy(config.button_pins, pins, sizeof(pins));
+    return config;
+}
+
+bool load(config_t& config) {
+    Supervisor::Scope scope(Supervisor::ScopeStorage);
+    Preferences preferences;
+    if (!preferences.begin(SETTINGS_NAMESPACE, true)) {
+        return false; // Nothing saved yet (or no NVS), keep the defaults
+    }
+
+    for (const field_t& field : FIELDS) {
+        config.*field.value = preferences.getUShort(field.name, config.*field.value);
+    }
+    if (preferences.getBytesLength(SETTINGS_BUTTONS_KEY) == sizeof(config.button_pins)) {
+        preferences.getBytes(SETTINGS_BUTTONS_KEY, config.button_pins, sizeof(config.button_pins));
+    }
+    preferences.end();
+
+    if (!validate(config)) {
+        Serial.println(F("Warning: invalid saved settings replaced with the defaults"));
+    }
+    return true;
+}
+
+bool save(const config_t& config) {
+    Supervisor::Scope scope(Supervisor::ScopeStorage);
+    Preferences preferences;
+    if (!preferences.begin(SETTINGS_NAMESPACE, false)) {
+        Serial.println(F("Error: failed to open the settings storage!"));
+        return false;
+    }
+
+    bool ok = true;
+    for (const field_t& field : FIELDS) {
+        ok &= preferences.putUShort(field.name, config.*field.value) == sizeof(uint16_t);
+    }
+    size_t pins = sizeof(config.button_pins);
+    ok &= preferences.putBytes(SETTINGS_BUTTONS_KEY, config.button_pins, pins) == pins;
+    preferences.end();
+    return ok;
+}
+
+bool validate(config_t& config) {
+    const config_t fallback = defaults();
+    bool valid              = true;
+
+    for (const field_t& field : FIELDS) {
+        uint16_t value = config.*field.value;
+        if (value < field.min || value > field.max) {
+            config.*field.value = fallback.*field.value;
+            valid               = false;
+        }
+    }
+
+    for (uint8_t bank = 0; bank < BUTTON_BANKS_COUNT; bank++) {
+        for (uint8_t i = 0; i < COLORS_COUNT; i++) {
+            int8_t pin = config.button_pins[bank][i];
+            if (pin < 0 || pin > SETTINGS_MAX_PIN) {
+                config.button_pins[bank][i] = fallback.button_pins[bank][i];
+                valid                       = false;
+            }
+        }
+    }
+
+    // The game has to dim before it sleeps
+    if (config.power_sleep_s <= config.power_dim_s) {
+        config.power_dim_s   = fallback.power_dim_s;
+        config.power_sleep_s = fallback.power_sleep_s;
+        valid                = false;
+    }
+    return valid;
+}
+
+uint8_t fieldsCount() { return FIELDS_COUNT; }
+
+const field_t& field(uint8_t index) { return FIELDS[index]; }
+
+const field_t* find(const char* name) {
+    for (const field_t& field : FIELDS) {
+        if (strcmp(field.name, name) == 0) {
+            return &field;
+        }
+    }
+    return nullptr;
+}
+
+void print(const config_t& config, const field_t& field) {
+    Serial.print(field.name);
+    Serial.print(F(" = "));
+    Serial.print(config.*field.value);
+    Serial.print(F(" ["));
+    Serial.print(field.min);
+    Serial.print(F(".."));
+    Serial.print(field.max);
+    Serial.print(']');
+    if (field.boot) {
+        Serial.print(F(" (boot)"));
+    }
+    Serial.println();
+}
+
+} // namespace Settings
+} // namespace simon
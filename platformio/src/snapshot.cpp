@@ -0,0 +1,124 @@
+#include "snapshot.h"
+#include "modes.h"
+#include <esp_system.h>
+
+namespace simon {
+namespace Snapshot {
+
+#define SNAPSHOT_MAGIC 0x53494D33 // "SIM3", changes with the record layout
+
+typedef struct SnapshotRecord {
+    uint32_t magic;
+    game_snapshot_t game;
+    uint8_t length;                                // Sequence length
+    uint8_t resumes;                               // Restores since the round was saved
+    uint16_t colors_crc;                           // Of the complete color bytes
+    uint8_t colors[(MAX_SEQUENCE_LENGTH + 3) / 4]; // 2 bits per color
+    uint16_t crc; // Of the header, colors_crc and the partial last color byte
+} snapshot_record_t;
+
+// Not cleared by the startup code, validated by the magic and the CRC
+static RTC_NOINIT_ATTR snapshot_record_t record;
+
+static uint16_t crc16(const uint8_t* data, size_t length, uint16_t crc = 0xFFFF) {
+    // CRC-16/CCITT, bitwise: a snapshot is a few dozen bytes
+    while (length--) {
+        crc ^= (uint16_t)*data++ << 8;
+        for (uint8_t bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+        }
+    }
+    return crc;
+}
+
+static uint16_t recordCrc() {
+    // Fixed cost: the complete color bytes are covered by colors_crc
+    uint16_t crc = crc16(reinterpret_cast<const uint8_t*>(&record.game), sizeof(record.game));
+    crc          = crc16(&record.length, sizeof(record.length), crc);
+    crc          = crc16(&record.resumes, sizeof(record.resumes), crc);
+    crc          = crc16(reinterpret_cast<const uint8_t*>(&record.colors_crc),
+                         sizeof(record.colors_crc),
+                         crc);
+    return crc16(record.colors + record.length / 4, (record.length & 3) != 0, crc);
+}
+
+void save(const game_snapshot_t& game, const Sequence& sequence, uint8_t changed_from) {
+    uint8_t sealed = record.length / 4; // Color bytes already in colors_crc
+    if (record.magic != SNAPSHOT_MAGIC || changed_from > record.length) {
+        // Nothing to build on, the whole sequence is written
+        record.magic   = SNAPSHOT_MAGIC;
+        record.resumes = 0;
+        changed_from   = 0;
+    }
+    if (changed_from / 4 < sealed || changed_from == 0) {
+        sealed            = 0; // A complete byte changed, its CRC is computed again
+        record.colors_crc = 0xFFFF;
+    }
+
+    // A round past the resumed one: the resume went through
+    if (record.length != sequence.size()) {
+        record.resumes = 0;
+    }
+
+    record.game   = game;
+    record.length = sequence.size();
+
+    // Usually a single byte, the one holding the new color
+    for (uint8_t byte = changed_from / 4; byte < (sequence.size() + 3) / 4; byte++) {
+        uint8_t packed = 0;
+        for (uint8_t i = byte * 4; i < byte * 4 + 4 && i < sequence.size(); i++) {
+            packed |= (sequence[i] & 0x03) << ((i & 3) * 2);
+        }
+        record.colors[byte] = packed;
+    }
+
+    for (; sealed < record.length / 4; sealed++) {
+        record.colors_crc = crc16(&record.colors[sealed], 1, record.colors_crc);
+    }
+    record.crc = recordCrc();
+}
+
+static bool rtcMemoryKept() {
+    // The RTC memory is powered through these resets. A brownout may have damaged it,
+    // which the 32 bit magic and the CRC catch. After a power-on (or an unknown reset)
+    // it holds whatever it came up with: a new game starts
+    switch (esp_reset_reason()) {
+    case ESP_RST_SW:
+    case ESP_RST_PANIC:
+    case ESP_RST_INT_WDT:
+    case ESP_RST_TASK_WDT:
+    case ESP_RST_WDT:
+    case ESP_RST_BROWNOUT: return true;
+    default:               return false;
+    }
+}
+
+bool restore(game_snapshot_t& game, Sequence& sequence) {
+    if (!rtcMemoryKept() || record.magic != SNAPSHOT_MAGIC || record.length == 0 ||
+        record.length > MAX_SEQUENCE_LENGTH || record.game.mode >= GAME_MODES_COUNT ||
+        record.crc != recordCrc() || record.colors_crc != crc16(record.colors, record.length / 4)) {
+        discard();
+        return false;
+    }
+
+    if (record.resumes > 0) {
+        // The last resume reset again before finishing the round, don't loop on it
+        Serial.println(F("Error: resumed game failed again, discarded!"));
+        discard();
+        return false;
+    }
+    record.resumes++;
+    record.crc = recordCrc();
+
+    game = record.game;
+    sequence.clear();
+    for (uint8_t i = 0; i < record.length; i++) {
+        sequence.push(static_cast<color_t>((record.colors[i / 4] >> ((i & 3) * 2)) & 0x03));
+    }
+    return true;
+}
+
+void discard() { record.magic = 0; }
+
+} // namespace Snapshot
+} // namespace simon
@@ -0,0 +1,104 @@
+#include "sprites.h"
+
+using namespace simon;
+
+// Glyph cell of the built-in 5x7 font, including spacing
+#define GLYPH_WIDTH  6
+#define GLYPH_HEIGHT 8
+
+bool TextCache::add(const char* str) {
+    if (find(str) != nullptr) {
+        return true;
+    }
+
+    uint8_t width, pages;
+    measure(str, width, pages);
+    uint16_t bytes = width * pages;
+
+    if (_count >= TEXT_CACHE_SPRITES || _used + bytes > TEXT_CACHE_BYTES) {
+        Serial.println(F("Error: text cache is full!"));
+        return false;
+    }
+
+    // Render with GFX once, then convert to the SSD1306 page layout. The canvas is as
+    // wide as the screen so that long strings wrap where they would on screen
+    GFXcanvas1 canvas(SCREEN_WIDTH, pages * 8);
+    canvas.fillScreen(0);
+    canvas.setTextWrap(true);
+    canvas.setTextSize(_size);
+    canvas.setTextColor(1);
+    canvas.setCursor(0, 0);
+    canvas.print(FPSTR(str));
+
+    uint8_t* bitmap = _pool + _used;
+    for (uint8_t page = 0; page < pages; page++) {
+        for (uint16_t x = 0; x < width; x++) {
+            uint8_t column = 0;
+            for (uint8_t bit = 0; bit < 8; bit++) {
+                if (canvas.getPixel(x, page * 8 + bit)) {
+                    column |= 1 << bit;
+                }
+            }
+            bitmap[page * width + x] = column;
+        }
+    }
+
+    _sprites[_count++] = {str, _used, width, pages};
+    _used += bytes;
+    return true;
+}
+
+void TextCache::measure(const char* str, uint8_t& width, uint8_t& pages) const {
+    const uint16_t glyph_width = GLYPH_WIDTH * _size;
+    const uint16_t per_line    = SCREEN_WIDTH / glyph_width; // GFX wraps before clipping
+    const uint16_t length      = strlen_P(str);
+    const uint16_t lines       = length > per_line ? (length + per_line - 1) / per_line : 1;
+
+    width = min<uint16_t>(length, per_line) * glyph_width;
+    pages = lines * ((GLYPH_HEIGHT * _size + 7) / 8);
+}
+
+const text_sprite_t* TextCache::find(const char* str) const {
+    for (uint8_t i = 0; i < _count; i++) {
+        if (_sprites[i].key == str) {
+            return &_sprites[i];
+        }
+    }
+    return nullptr;
+}
+
+void TextCache::draw(Adafruit_SSD1306& display, const char* str, int16_t x, uint8_t page) const {
+    const text_sprite_t* sprite = find(str);
+
+    if (sprite == nullptr) {
+        // Not cached: draw it glyph by glyph
+        display.setTextSize(_size);
+        if (x < 0) {
+            int16_t x1, y1;
+            uint16_t w, h;
+            display.getTextBounds(FPSTR(str), 0, 0, &x1, &y1, &w, &h);
+            x = (SCREEN_WIDTH - w) / 2;
+        }
+        display.setCursor(x, page * 8);
+        display.print(FPSTR(str));
+        return;
+    }
+
+    if (x < 0) {
+        x = (SCREEN_WIDTH - sprite->width) / 2;
+    } else if (x >= SCREEN_WIDTH) {
+        return;
+    }
+
+    uint8_t* buffer = display.getBuffer();
+    if (buffer == nullptr) {
+        return; // Display not initialized
+    }
+    uint16_t width = min<uint16_t>(sprite->width, SCREEN_WIDTH - x);
+
+    for (uint8_t p = 0; p < sprite->pages && page + p < SCREEN_HEIGHT / 8; p++) {
+        memcpy(buffer + (page + p) * SCREEN_WIDTH + x,
+               _pool + sprite->offset + p * sprite->width,
+               width);
+    }
+}
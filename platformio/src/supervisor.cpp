@@ -0,0 +1,202 @@
+#include "supervisor.h"
+#include "fsm.h"
+#include <esp_system.h>
+#include <esp_task_wdt.h>
+
+namespace simon {
+namespace Supervisor {
+
+#define SUPERVISOR_MAGIC 0x57444F47 // "WDOG", changes with the record layout
+
+static const char SCOPE_NONE[] PROGMEM        = "none";
+static const char SCOPE_CONSOLE[] PROGMEM     = "console";
+static const char SCOPE_BUTTONS[] PROGMEM     = "buttons";
+static const char SCOPE_TIMERS[] PROGMEM      = "timers";
+static const char SCOPE_STATE[] PROGMEM       = "state";
+static const char SCOPE_LEDS[] PROGMEM        = "leds";
+static const char SCOPE_DISPLAY[] PROGMEM     = "display";
+static const char SCOPE_STORAGE[] PROGMEM     = "storage";
+static const char SCOPE_CELEBRATION[] PROGMEM = "celebration";
+static const char SCOPE_SLEEP[] PROGMEM       = "sleep";
+
+static const char* const SCOPE_NAMES[SCOPES_COUNT] = {
+    SCOPE_NONE,
+    SCOPE_CONSOLE,
+    SCOPE_BUTTONS,
+    SCOPE_TIMERS,
+    SCOPE_STATE,
+    SCOPE_LEDS,
+    SCOPE_DISPLAY,
+    SCOPE_STORAGE,
+    SCOPE_CELEBRATION,
+    SCOPE_SLEEP,
+};
+
+typedef struct SupervisorRecord {
+    uint32_t magic;
+    uint32_t iteration;                   // Loop iterations since boot
+    uint32_t loop_start_ms;               // millis() when the last iteration started
+    uint32_t max_loop_us;                 // Longest iteration so far
+    uint8_t state;                        // FSM state of the last iteration
+    uint8_t depth;                        // Scopes currently active
+    uint8_t scopes[SUPERVISOR_MAX_DEPTH]; // Active scopes, outermost first
+} supervisor_record_t;
+
+// Not cleared by the startup code, survives the watchdog reset
+static RTC_NOINIT_ATTR supervisor_record_t record;
+
+static TaskHandle_t loop_task = nullptr;
+static bool watchdog          = false;
+static uint32_t loop_start_us = 0;
+static uint32_t slow_loops    = 0; // Iterations longer than SUPERVISOR_LOOP_BUDGET_US
+static uint8_t max_loop_state = 0; // State of the longest iteration
+
+Scope::Scope(scope_id_t scope) : _recorded(xTaskGetCurrentTaskHandle() == loop_task) {
+    if (!_recorded) {
+        return;
+    }
+    if (record.depth < SUPERVISOR_MAX_DEPTH) {
+        record.scopes[record.depth] = scope;
+    }
+    record.depth++; // Deeper scopes are counted, not named
+}
+
+Scope::~Scope() {
+    if (_recorded && record.depth > 0) {
+        record.depth--;
+    }
+}
+
+static void printState(uint8_t state) {
+    if (state < Fsm::STATE_TYPES_COUNT) {
+        Serial.print(Fsm::stateTypeToString(static_cast<Fsm::StateType>(state)));
+    } else {
+        Serial.print(state);
+    }
+}
+
+static void printScopes() {
+    if (record.depth == 0) {
+        Serial.print(FPSTR(SCOPE_NONE));
+    }
+    for (uint8_t i = 0; i < record.depth && i < SUPERVISOR_MAX_DEPTH; i++) {
+        if (i > 0) {
+            Serial.print(F(" > "));
+        }
+        uint8_t scope = record.scopes[i];
+        Serial.print(FPSTR(SCOPE_NAMES[scope < SCOPES_COUNT ? scope : ScopeNone]));
+    }
+    if (record.depth > SUPERVISOR_MAX_DEPTH) {
+        Serial.print(F(" > ..."));
+    }
+}
+
+void begin() {
+    loop_task = xTaskGetCurrentTaskHandle();
+
+    esp_reset_reason_t reason = esp_reset_reason();
+    bool watchdog_reset =
+        reason == ESP_RST_TASK_WDT || reason == ESP_RST_INT_WDT || reason == ESP_RST_WDT;
+
+    if ((watchdog_reset || reason == ESP_RST_PANIC) && record.magic == SUPERVISOR_MAGIC) {
+        Serial.print(F("Post-mortem: "));
+        Serial.print(watchdog_reset ? F("watchdog reset") : F("panic"));
+        Serial.print(F(" in state "));
+        printState(record.state);
+        Serial.print(F(", scope "));
+        printScopes();
+        Serial.println();
+        Serial.print(F("  iteration "));
+        Serial.print(record.iteration);
+        Serial.print(F(" started at "));
+        Serial.print(record.loop_start_ms);
+        Serial.print(F(" ms, longest loop "));
+        Serial.print(record.max_loop_us / 1000);
+        Serial.println(F(" ms"));
+    }
+
+    memset(&record, 0, sizeof(record));
+    record.magic = SUPERVISOR_MAGIC;
+}
+
+void startWatchdog() {
+#if ESP_ARDUINO_VERSION_MAJOR >= 3
+    // Only the loop task is watched, the idle tasks are not subscribed
+    esp_task_wdt_config_t config;
+    config.timeout_ms     = SUPERVISOR_WDT_MS;
+    config.idle_core_mask = 0;
+    config.trigger_panic  = true;
+    if (esp_task_wdt_reconfigure(&config) != ESP_OK) {
+        esp_task_wdt_init(&config); // Not started by the core
+    }
+#else
+    esp_task_wdt_init((SUPERVISOR_WDT_MS + 999) / 1000, true);
+#endif
+
+    if (esp_task_wdt_add(loop_task) != ESP_OK) {
+        Serial.println(F("Error: failed to start the loop watchdog!"));
+        return;
+    }
+    watchdog = true;
+}
+
+void loopStart(uint8_t state) {
+    loop_start_us        = micros();
+    record.loop_start_ms = millis();
+    record.state         = state;
+    record.depth         = 0;
+    record.iteration++;
+}
+
+void loopEnd() {
+    uint32_t duration_us = micros() - loop_start_us;
+    if (duration_us > record.max_loop_us) {
+        record.max_loop_us = duration_us;
+        max_loop_state     = record.state;
+    }
+    if (duration_us > SUPERVISOR_LOOP_BUDGET_US) {
+        slow_loops++;
+    }
+
+    if (watchdog) {
+        esp_task_wdt_reset();
+    }
+}
+
+void setState(uint8_t state) { record.state = state; }
+
+void suspend() {
+    if (watchdog) {
+        esp_task_wdt_delete(loop_task);
+    }
+}
+
+void resume() {
+    if (watchdog) {
+        esp_task_wdt_add(loop_task);
+        esp_task_wdt_reset();
+    }
+}
+
+void printReport() {
+    Serial.print(F("Loop: "));
+    Serial.print(record.iteration);
+    Serial.print(F(" iterations, longest "));
+    Serial.print(record.max_loop_us / 1000);
+    Serial.print(F(" ms in "));
+    printState(max_loop_state);
+    Serial.print(F(", "));
+    Serial.print(slow_loops);
+    Serial.print(F(" over "));
+    Serial.print(SUPERVISOR_LOOP_BUDGET_US / 1000);
+    Serial.print(F(" ms, watchdog "));
+    if (watchdog) {
+        Serial.print(SUPERVISOR_WDT_MS);
+        Serial.println(F(" ms"));
+    } else {
+        Serial.println(F("off"));
+    }
+}
+
+} // namespace Supervisor
+} // namespace simon
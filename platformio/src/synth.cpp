@@ -0,0 +1,227 @@
+#include "synth.h"
+#include "tones.h"
+
+using namespace simon;
+
+// Loudest duty cycle: a 50% square wave
+#define SYNTH_DUTY_MAX ((1 << SYNTH_PWM_BITS) / 2)
+
+// The LEDC API is keyed by pin since core 3.x and by channel before
+#if ESP_ARDUINO_VERSION_MAJOR >= 3
+#define SYNTH_LEDC_TARGET _pin
+#else
+#define SYNTH_LEDC_TARGET SYNTH_LEDC_CHANNEL
+#endif
+
+// Short attack and release to avoid clicks on plain tones
+static const synth_envelope_t ENVELOPE_TONE = {4, 0, 255, 8};
+
+// Plucked notes for melodies
+static const synth_envelope_t ENVELOPE_MELODY = {4, 60, 170, 20};
+
+Synth::Synth() {
+    for (uint8_t i = 0; i < SOUND_PRIORITIES; i++) {
+        _voices[i]        = {};
+        _voices[i].active = false;
+    }
+}
+
+bool Synth::begin(int8_t pin) {
+    _pin = pin;
+
+#if ESP_ARDUINO_VERSION_MAJOR >= 3
+    if (!ledcAttach(_pin, NOTE_C5, SYNTH_PWM_BITS)) {
+        Serial.println(F("Error: failed to attach the buzzer PWM!"));
+        return false;
+    }
+#else
+    ledcSetup(SYNTH_LEDC_CHANNEL, NOTE_C5, SYNTH_PWM_BITS);
+    ledcAttachPin(_pin, SYNTH_LEDC_CHANNEL);
+#endif
+    ledcWrite(SYNTH_LEDC_TARGET, 0);
+    _out_note = NOTE_C5;
+    _out_duty = 0;
+
+    if (_timer != nullptr) {
+        return true;
+    }
+
+    esp_timer_create_args_t args = {};
+    args.callback                = &Synth::onTick;
+    args.arg                     = this;
+    args.dispatch_method         = ESP_TIMER_TASK;
+    args.name                    = "synth";
+
+    if (esp_timer_create(&args, &_timer) != ESP_OK ||
+        esp_timer_start_periodic(_timer, SYNTH_TICK_MS * 1000ULL) != ESP_OK) {
+        Serial.println(F("Error: failed to start the synth timer!"));
+        return false;
+    }
+    return true;
+}
+
+void Synth::loadStep(voice_t& voice) {
+    if (voice.steps != nullptr) {
+        voice.step = voice.steps[voice.index];
+        return;
+    }
+
+    // Decode the packed melody event
+    const melody_event_t& event = voice.melody->events[voice.index];
+    uint16_t length             = (event.ticks * voice.melody->tick_us) / 1000;
+    uint16_t on_ms              = (length * MELODY_GATE_PERCENT) / 100;
+    voice.step                  = {NOTE_FREQUENCIES[event.note], on_ms, uint16_t(length - on_ms)};
+}
+
+void Synth::start(sound_priority_t priority,
+                  const synth_step_t* steps,
+                  const melody_t* melody,
+                  uint16_t count,
+                  const synth_envelope_t* envelope) {
+    if (_timer == nullptr) {
+        return; // Not started (or the buzzer failed to initialize)
+    }
+
+    portENTER_CRITICAL(&_lock);
+    voice_t& voice   = _voices[priority];
+    voice.steps      = steps;
+    voice.melody     = melody;
+    voice.count      = count;
+    voice.envelope   = envelope;
+    voice.index      = 0;
+    voice.elapsed_ms = 0;
+    voice.active     = count > 0;
+    if (voice.active) {
+        loadStep(voice);
+    }
+    portEXIT_CRITICAL(&_lock);
+}
+
+void Synth::play(const synth_sound_t& sound, sound_priority_t priority) {
+    start(priority, sound.steps, nullptr, sound.count, sound.envelope);
+}
+
+void Synth::play(const melody_t& melody, sound_priority_t priority) {
+    start(priority, nullptr, &melody, melody.count, &ENVELOPE_MELODY);
+}
+
+void Synth::tone(note_t note, uint16_t duration_ms, sound_priority_t priority) {
+    voice_t& voice = _voices[priority];
+
+    portENTER_CRITICAL(&_lock);
+    voice.live = {note, duration_ms, 0};
+    portEXIT_CRITICAL(&_lock);
+
+    start(priority, &voice.live, nullptr, 1, &ENVELOPE_TONE);
+}
+
+void Synth::stop(sound_priority_t priority) {
+    portENTER_CRITICAL(&_lock);
+    _voices[priority].active = false;
+    portEXIT_CRITICAL(&_lock);
+}
+
+void Synth::stopAll() {
+    portENTER_CRITICAL(&_lock);
+    for (uint8_t i = 0; i < SOUND_PRIORITIES; i++) {
+        _voices[i].active = false;
+    }
+    portEXIT_CRITICAL(&_lock);
+}
+
+void Synth::suspend() {
+    stopAll();
+    if (_timer != nullptr) {
+        esp_timer_stop(_timer);
+    }
+
+    ledcWrite(SYNTH_LEDC_TARGET, 0);
+    _out_duty = 0;
+}
+
+void Synth::resume() {
+    if (_timer != nullptr) {
+        esp_timer_start_periodic(_timer, SYNTH_TICK_MS * 1000ULL);
+    }
+}
+
+uint8_t Synth::envelopeLevel(const synth_envelope_t& envelope, uint16_t elapsed_ms) {
+    if (elapsed_ms < envelope.attack_ms) {
+        return (255UL * elapsed_ms) / envelope.attack_ms;
+    }
+
+    elapsed_ms -= envelope.attack_ms;
+    if (elapsed_ms < envelope.decay_ms) {
+        return 255 - ((255UL - envelope.sustain) * elapsed_ms) / envelope.decay_ms;
+    }
+
+    return envelope.sustain;
+}
+
+void Synth::onTick(void* arg) { static_cast<Synth*>(arg)->tick(); }
+
+void Synth::tick() {
+    uint16_t note = 0;
+    uint32_t duty = 0;
+
+    portENTER_CRITICAL(&_lock);
+
+    // Every voice keeps its own time, preempted ones included
+    for (uint8_t i = 0; i < SOUND_PRIORITIES; i++) {
+        voice_t& voice = _voices[i];
+        if (!voice.active) {
+            continue;
+        }
+
+        voice.elapsed_ms += SYNTH_TICK_MS;
+
+        uint16_t length = voice.step.on_ms + voice.step.off_ms;
+        if (voice.step.on_ms != 0 && voice.elapsed_ms >= length) {
+            voice.elapsed_ms -= length;
+            if (++voice.index >= voice.count) {
+                voice.active = false;
+            } else {
+                loadStep(voice);
+            }
+        }
+    }
+
+    // The highest priority voice drives the output
+    for (int8_t i = SOUND_PRIORITIES - 1; i >= 0; i--) {
+        const voice_t& voice = _voices[i];
+        if (!voice.active) {
+            continue;
+        }
+
+        const synth_step_t& step         = voice.step;
+        const synth_envelope_t& envelope = *voice.envelope;
+
+        uint32_t level;
+        if (step.on_ms == 0 || voice.elapsed_ms < step.on_ms) {
+            level = envelopeLevel(envelope, voice.elapsed_ms);
+        } else {
+            // Release: fade from the level reached at the end of the note
+            uint16_t released = voice.elapsed_ms - step.on_ms;
+            level             = released < envelope.release_ms
+                                    ? envelopeLevel(envelope, step.on_ms) *
+                                          (envelope.release_ms - released) / envelope.release_ms
+                                    : 0;
+        }
+
+        note = step.note;
+        duty = note == 0 ? 0 : (SYNTH_DUTY_MAX * level * _volume) >> 16;
+        break;
+    }
+
+    portEXIT_CRITICAL(&_lock);
+
+    if (duty > 0 && note != _out_note) {
+        ledcChangeFrequency(SYNTH_LEDC_TARGET, note, SYNTH_PWM_BITS);
+        _out_note = note;
+    }
+
+    if (duty != _out_duty) {
+        ledcWrite(SYNTH_LEDC_TARGET, duty);
+        _out_duty = duty;
+    }
+}
@@ -0,0 +1,96 @@
+#include "timeline.h"
+
+using namespace simon;
+
+// -------------------------------------------
+// Timeline
+// -------------------------------------------
+
+void Timeline::clear() {
+    _size        = 0;
+    _duration_ms = 0;
+}
+
+bool Timeline::add(uint16_t delay_ms, timeline_action_type_t type, uint8_t arg) {
+    if (_size >= TIMELINE_MAX_ACTIONS) {
+        return false;
+    }
+
+    _actions[_size++] = {delay_ms, static_cast<uint8_t>(type), arg};
+    _duration_ms += delay_ms;
+    return true;
+}
+
+void simon::compileSequence(Timeline& timeline,
+                            const Sequence& sequence,
+                            uint8_t first,
+                            const step_timing_t& timing,
+                            uint16_t lead_in_ms) {
+    timeline.clear();
+
+    uint16_t wait = lead_in_ms;
+    for (uint8_t i = first; i < sequence.size(); i++) {
+        uint8_t color = static_cast<uint8_t>(sequence[i]);
+
+        // LEDs and tone first, the slower display update last
+        timeline.add(wait, ActionLedOn, color);
+        timeline.add(0, ActionToneOn, color);
+        timeline.add(0, ActionDisplay, color);
+
+        if (timing.tone_ms < timing.on_ms) {
+            timeline.add(timing.tone_ms, ActionToneOff);
+            timeline.add(timing.on_ms - timing.tone_ms, ActionLedOff);
+        } else {
+            timeline.add(timing.on_ms, ActionLedOff);
+            timeline.add(0, ActionToneOff);
+        }
+
+        wait = timing.off_ms;
+    }
+
+    timeline.add(wait, ActionEnd);
+}
+
+// -------------------------------------------
+// TimelinePlayer
+// -------------------------------------------
+
+void TimelinePlayer::start(const Timeline& timeline, uint32_t now_us) {
+    _timeline        = &timeline;
+    _next            = 0;
+    _start_us        = now_us;
+    _due_ms          = timeline.size() > 0 ? timeline[0].delay_ms : 0;
+
+    _jitter_max_us   = 0;
+    _jitter_total_us = 0;
+    _jitter_count    = 0;
+}
+
+bool TimelinePlayer::poll(uint32_t now_us, timeline_action_t& action) {
+    if (_timeline == nullptr) {
+        return false;
+    }
+
+    if (_next >= _timeline->size()) {
+        stop();
+        return false;
+    }
+
+    int32_t late_us = static_cast<int32_t>((now_us - _start_us) - _due_ms * 1000UL);
+    if (late_us < 0) {
+        return false; // Not due yet
+    }
+
+    // Lateness against the nominal schedule
+    _jitter_total_us += late_us;
+    _jitter_count++;
+    if (static_cast<uint32_t>(late_us) > _jitter_max_us) {
+        _jitter_max_us = late_us;
+    }
+
+    action = (*_timeline)[_next++];
+    if (_next < _timeline->size()) {
+        _due_ms += (*_timeline)[_next].delay_ms;
+    }
+    return true;
+}
@@ -0,0 +1,116 @@
+#include "timers.h"
+
+using namespace simon;
+
+TimerWheel::TimerWheel() {
+    for (uint8_t i = 0; i < TIMER_WHEEL_SLOTS; i++) {
+        _slots[i] = TIMER_NONE;
+    }
+    for (uint8_t i = 0; i < TIMER_WHEEL_TIMERS; i++) {
+        _timers[i]       = {};
+        _timers[i].armed = false;
+    }
+}
+
+void TimerWheel::begin(uint32_t now_ms) { _last_ms = now_ms; }
+
+void TimerWheel::link(uint8_t id, uint32_t ticks) {
+    ticks = max<uint32_t>(ticks, 1);
+
+    // The slot is visited every TIMER_WHEEL_SLOTS ticks before the expiry one
+    wheel_timer_t& timer = _timers[id];
+    timer.slot           = (_tick + ticks) % TIMER_WHEEL_SLOTS;
+    timer.rounds         = (ticks - 1) / TIMER_WHEEL_SLOTS;
+    timer.prev           = TIMER_NONE;
+    timer.next           = _slots[timer.slot];
+    timer.armed          = true;
+
+    if (timer.next != TIMER_NONE) {
+        _timers[timer.next].prev = id;
+    }
+    _slots[timer.slot] = id;
+}
+
+void TimerWheel::unlink(uint8_t id) {
+    wheel_timer_t& timer = _timers[id];
+    timer.pending        = false; // A cancelled or re-armed timer is not reported
+    if (!timer.armed) {
+        return;
+    }
+
+    if (timer.prev != TIMER_NONE) {
+        _timers[timer.prev].next = timer.next;
+    } else {
+        _slots[timer.slot] = timer.next;
+    }
+    if (timer.next != TIMER_NONE) {
+        _timers[timer.next].prev = timer.prev;
+    }
+    timer.armed = false;
+}
+
+void TimerWheel::arm(uint8_t id, uint32_t delay_ms, uint8_t state, uint32_t period_ms) {
+    if (id >= TIMER_WHEEL_TIMERS) {
+        Serial.println(F("Error: invalid timer id!"));
+        return;
+    }
+
+    unlink(id);
+    _timers[id].state  = state;
+    _timers[id].period = (period_ms + TIMER_TICK_MS - 1) / TIMER_TICK_MS;
+
+    // Round up: a timer never expires early
+    link(id, (delay_ms + TIMER_TICK_MS - 1) / TIMER_TICK_MS);
+}
+
+void TimerWheel::cancel(uint8_t id) {
+    if (id < TIMER_WHEEL_TIMERS) {
+        unlink(id);
+    }
+}
+
+void TimerWheel::cancelState(uint8_t state) {
+    for (uint8_t i = 0; i < TIMER_WHEEL_TIMERS; i++) {
+        if (_timers[i].armed && _timers[i].state == state) {
+            unlink(i);
+        }
+    }
+}
+
+void TimerWheel::poll(uint32_t now_ms) {
+    while (now_ms - _last_ms >= TIMER_TICK_MS) {
+        _last_ms += TIMER_TICK_MS;
+        _tick++;
+
+        uint8_t expired[TIMER_WHEEL_TIMERS];
+        uint8_t count = 0;
+
+        int8_t id = _slots[_tick % TIMER_WHEEL_SLOTS];
+        while (id != TIMER_NONE) {
+            wheel_timer_t& timer = _timers[id];
+            int8_t next          = timer.next;
+
+            if (timer.rounds > 0) {
+                timer.rounds--;
+            } else {
+                unlink(id);
+                if (timer.period > 0) {
+                    link(id, timer.period);
+                }
+                timer.pending    = true;
+                expired[count++] = id;
+            }
+            id = next;
+        }
+
+        // Reported once the slot is consistent again, unless an earlier callback
+        // cancelled the timer in the meantime
+        for (uint8_t i = 0; i < count; i++) {
+            wheel_timer_t& timer = _timers[expired[i]];
+            if (timer.pending && _expired_cb) {
+                timer.pending = false;
+                _expired_cb(expired[i]);
+            }
+        }
+    }
+}
@@ -18,16 +18,24 @@ simon::note_t colorToNote(simon::color_t color) {
     }
 }
 
-String colorToString(simon::color_t color) {
+const char PROGMEM STR_COLOR_YELLOW[] = "Yellow";
+const char PROGMEM STR_COLOR_GREEN[]  = "Green";
+const char PROGMEM STR_COLOR_RED[]    = "Red";
+const char PROGMEM STR_COLOR_BLUE[]   = "Blue";
+const char PROGMEM STR_COLOR_NONE[]   = "None";
+
+const char* colorToName(simon::color_t color) {
     switch (color) {
-    case ColorYellow: return F("Yellow");
-    case ColorGreen:  return F("Green");
-    case ColorRed:    return F("Red");
-    case ColorBlue:   return F("Blue");
-    default:          return F("None");
+    case ColorYellow: return STR_COLOR_YELLOW;
+    case ColorGreen:  return STR_COLOR_GREEN;
+    case ColorRed:    return STR_COLOR_RED;
+    case ColorBlue:   return STR_COLOR_BLUE;
+    default:          return STR_COLOR_NONE;
     }
 }
 
+const __FlashStringHelper* colorToString(simon::color_t color) { return FPSTR(colorToName(color)); }
+
 uint32_t colorToRGB(simon::color_t color) {
     switch (color) {
     case ColorYellow: return Adafruit_NeoPixel::Color(255, 255, 0); // Yellow
@@ -0,0 +1,14 @@
+#ifndef __SIMON_NATIVE_NEOPIXEL_H__
+#define __SIMON_NATIVE_NEOPIXEL_H__
+
+#include <Arduino.h>
+
+// Color packing only, the native environment drives no strip
+class Adafruit_NeoPixel {
+  public:
+    static uint32_t Color(uint8_t r, uint8_t g, uint8_t b) {
+        return ((uint32_t)r << 16) | ((uint32_t)g << 8) | b;
+    }
+};
+
+#endif // __SIMON_NATIVE_NEOPIXEL_H__
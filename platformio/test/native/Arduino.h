@@ -0,0 +1,85 @@
+#ifndef __SIMON_NATIVE_ARDUINO_H__
+#define __SIMON_NATIVE_ARDUINO_H__
+
+//
+// Host stand-in for the Arduino and ESP32 core calls made by the modules built in the
+// native test environment (see build_src_filter in platformio.ini). Time only moves
+// when a test advances it, serial output is dropped.
+//
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+#define PROGMEM
+#define RTC_NOINIT_ATTR
+
+class __FlashStringHelper;
+
+#define F(s)                reinterpret_cast<const __FlashStringHelper*>(s)
+#define FPSTR(s)            reinterpret_cast<const __FlashStringHelper*>(s)
+#define strlen_P            strlen
+#define pgm_read_byte(addr) (*(const uint8_t*)(addr))
+
+using std::max;
+using std::min;
+
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+// Clock
+// ------------------------------------------------------
+
+namespace native {
+inline uint32_t now_us = 0;
+
+inline void advanceMs(uint32_t ms) { now_us += ms * 1000; }
+} // namespace native
+
+inline unsigned long micros() { return native::now_us; }
+
+inline unsigned long millis() { return native::now_us / 1000; }
+
+inline void delay(unsigned long ms) { native::advanceMs(ms); }
+
+inline long random(long low, long high) { return low + rand() % (high - low); }
+
+// Serial
+// ------------------------------------------------------
+
+class HardwareSerial {
+  public:
+    template <typename T> size_t print(T) { return 0; }
+
+    template <typename T> size_t print(T, int) { return 0; }
+
+    template <typename T> size_t println(T) { return 0; }
+
+    size_t println() { return 0; }
+};
+
+inline HardwareSerial Serial;
+
+// ESP32 heap and critical sections
+// ------------------------------------------------------
+
+class EspClass {
+  public:
+    uint32_t getFreeHeap() { return 0; }
+
+    uint32_t getHeapSize() { return 0; }
+
+    uint32_t getMinFreeHeap() { return 0; }
+
+    uint32_t getMaxAllocHeap() { return 0; }
+};
+
+inline EspClass ESP;
+
+typedef int portMUX_TYPE;
+
+#define portMUX_INITIALIZER_UNLOCKED 0
+#define portENTER_CRITICAL(mux)      (void)(mux)
+#define portEXIT_CRITICAL(mux)       (void)(mux)
+
+#endif // __SIMON_NATIVE_ARDUINO_H__
@@ -0,0 +1,24 @@
+#ifndef __SIMON_NATIVE_ESP_SYSTEM_H__
+#define __SIMON_NATIVE_ESP_SYSTEM_H__
+
+typedef enum {
+    ESP_RST_UNKNOWN,
+    ESP_RST_POWERON,
+    ESP_RST_EXT,
+    ESP_RST_SW,
+    ESP_RST_PANIC,
+    ESP_RST_INT_WDT,
+    ESP_RST_TASK_WDT,
+    ESP_RST_WDT,
+    ESP_RST_DEEPSLEEP,
+    ESP_RST_BROWNOUT,
+    ESP_RST_SDIO,
+} esp_reset_reason_t;
+
+namespace native {
+inline esp_reset_reason_t reset_reason = ESP_RST_SW; // Set by the tests
+} // namespace native
+
+inline esp_reset_reason_t esp_reset_reason() { return native::reset_reason; }
+
+#endif // __SIMON_NATIVE_ESP_SYSTEM_H__
@@ -0,0 +1,126 @@
+#include "delegate.h"
+#include "memory.h"
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <unity.h>
+
+using namespace simon;
+
+//
+// Delegate against the std::function + std::bind callbacks it replaced: behavior,
+// allocations (through the memory accounting) and a host microbenchmark of the call.
+// The timings are printed, not asserted: they depend on the machine running the tests.
+//
+
+#define BENCHMARK_CALLS 20000000UL
+
+class Counter {
+  public:
+    uint32_t total = 0;
+
+    void add(uint8_t value) { total += value; }
+};
+
+static uint32_t free_total = 0;
+
+static void addFree(uint8_t value) { free_total += value; }
+
+static uint32_t allocations() { return Memory::module(Memory::ModuleCore).dynamic.allocations; }
+
+template <typename Callback> static double nsPerCall(const Callback& callback) {
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < BENCHMARK_CALLS; i++) {
+        callback(static_cast<uint8_t>(i));
+    }
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / BENCHMARK_CALLS;
+}
+
+void setUp() { free_total = 0; }
+
+void tearDown() {}
+
+void test_member_binding() {
+    Counter counter;
+    auto callback = Delegate<void(uint8_t)>::bind<Counter, &Counter::add>(&counter);
+
+    callback(3);
+    callback(4);
+    TEST_ASSERT_EQUAL(7, counter.total);
+}
+
+void test_free_function_binding() {
+    auto callback = Delegate<void(uint8_t)>::bind<&addFree>();
+
+    callback(5);
+    TEST_ASSERT_EQUAL(5, free_total);
+}
+
+void test_empty_delegate() {
+    Delegate<void(uint8_t)> empty;
+    Delegate<void(uint8_t)> null = nullptr;
+
+    TEST_ASSERT_FALSE(empty);
+    TEST_ASSERT_FALSE(null);
+    TEST_ASSERT_TRUE(Delegate<void(uint8_t)>::bind<&addFree>());
+}
+
+void test_delegate_never_allocates() {
+    Counter counter;
+    uint32_t before = allocations();
+
+    auto callback = Delegate<void(uint8_t)>::bind<Counter, &Counter::add>(&counter);
+    auto copy     = callback;
+    copy(1);
+
+    TEST_ASSERT_EQUAL(before, allocations());
+    TEST_ASSERT_EQUAL(2 * sizeof(void*), sizeof(callback));
+}
+
+void test_bound_std_function_allocates() {
+    // What the callbacks used to be: the bind object does not fit the small buffer
+    Counter counter;
+    uint32_t before = allocations();
+
+    std::function<void(uint8_t)> callback =
+        std::bind(&Counter::add, &counter, std::placeholders::_1);
+    callback(1);
+
+    TEST_ASSERT_EQUAL(1, counter.total);
+    TEST_ASSERT_TRUE(allocations() > before);
+}
+
+void test_benchmark_call() {
+    Counter delegate_counter;
+    Counter function_counter;
+    auto delegate = Delegate<void(uint8_t)>::bind<Counter, &Counter::add>(&delegate_counter);
+    std::function<void(uint8_t)> function =
+        std::bind(&Counter::add, &function_counter, std::placeholders::_1);
+
+    double delegate_ns = nsPerCall(delegate);
+    double function_ns = nsPerCall(function);
+
+    char line[96];
+    snprintf(line,
+             sizeof(line),
+             "Call: Delegate %.2f ns, std::function %.2f ns (%lu calls)",
+             delegate_ns,
+             function_ns,
+             BENCHMARK_CALLS);
+    TEST_MESSAGE(line);
+
+    // Both did all the work (and the calls were not optimized away)
+    TEST_ASSERT_EQUAL(delegate_counter.total, function_counter.total);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_member_binding);
+    RUN_TEST(test_free_function_binding);
+    RUN_TEST(test_empty_delegate);
+    RUN_TEST(test_delegate_never_allocates);
+    RUN_TEST(test_bound_std_function_allocates);
+    RUN_TEST(test_benchmark_call);
+    return UNITY_END();
+}
@@ -0,0 +1,87 @@
+#include "layout.h"
+#include <unity.h>
+
+using namespace simon;
+
+static LedLayout layout;
+
+static config_t configFor(uint16_t count, uint16_t type, uint16_t width, uint16_t offset) {
+    config_t config   = {};
+    config.led_count  = count;
+    config.led_layout = type;
+    config.led_width  = width;
+    config.led_offset = offset;
+    return config;
+}
+
+void setUp() { layout = LedLayout(); }
+
+void tearDown() {}
+
+void test_ring_quarters_start_at_offset() {
+    TEST_ASSERT_TRUE(layout.build(configFor(24, LED_LAYOUT_RING, 24, 3)));
+    TEST_ASSERT_EQUAL(24, layout.width());
+    TEST_ASSERT_EQUAL(1, layout.height());
+
+    const uint8_t first[] = {3, 4, 5, 6, 7, 8};
+    const uint8_t last[]  = {21, 22, 23, 0, 1, 2}; // Wraps around the ring
+    TEST_ASSERT_EQUAL(6, layout.segmentSize(0));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(first, layout.segment(0), 6);
+    TEST_ASSERT_EQUAL(6, layout.segmentSize(3));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(last, layout.segment(3), 6);
+}
+
+void test_serpentine_quadrants() {
+    // 6 x 4, odd rows wired right to left
+    TEST_ASSERT_TRUE(layout.build(configFor(24, LED_LAYOUT_SERPENTINE, 6, 0)));
+    TEST_ASSERT_EQUAL(6, layout.width());
+    TEST_ASSERT_EQUAL(4, layout.height());
+
+    TEST_ASSERT_EQUAL(0, layout.pixelAt(0, 0));
+    TEST_ASSERT_EQUAL(11, layout.pixelAt(0, 1));
+    TEST_ASSERT_EQUAL(6, layout.pixelAt(5, 1));
+
+    const uint8_t top_left[]     = {0, 1, 2, 11, 10, 9};
+    const uint8_t bottom_right[] = {15, 16, 17, 20, 19, 18};
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(top_left, layout.segment(0), 6);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(bottom_right, layout.segment(3), 6);
+}
+
+void test_matrix_quadrants() {
+    TEST_ASSERT_TRUE(layout.build(configFor(24, LED_LAYOUT_MATRIX, 6, 0)));
+
+    const uint8_t top_left[] = {0, 1, 2, 6, 7, 8};
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(top_left, layout.segment(0), 6);
+}
+
+void test_every_pixel_in_one_segment() {
+    TEST_ASSERT_TRUE(layout.build(configFor(24, LED_LAYOUT_SERPENTINE, 6, 0)));
+
+    uint8_t seen[24] = {};
+    for (uint8_t s = 0; s < COLORS_COUNT; s++) {
+        for (uint16_t i = 0; i < layout.segmentSize(s); i++) {
+            seen[layout.segment(s)[i]]++;
+        }
+    }
+    for (uint8_t pixel = 0; pixel < 24; pixel++) {
+        TEST_ASSERT_EQUAL(1, seen[pixel]);
+    }
+}
+
+void test_invalid_matrix_falls_back_to_strip() {
+    TEST_ASSERT_FALSE(layout.build(configFor(24, LED_LAYOUT_MATRIX, 5, 0)));
+    TEST_ASSERT_EQUAL(24, layout.width());
+    TEST_ASSERT_EQUAL(1, layout.height());
+    TEST_ASSERT_EQUAL(6, layout.segmentSize(0));
+    TEST_ASSERT_EQUAL(0, layout.segment(0)[0]);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_ring_quarters_start_at_offset);
+    RUN_TEST(test_serpentine_quadrants);
+    RUN_TEST(test_matrix_quadrants);
+    RUN_TEST(test_every_pixel_in_one_segment);
+    RUN_TEST(test_invalid_matrix_falls_back_to_strip);
+    return UNITY_END();
+}
@@ -0,0 +1,176 @@
+#include "difficulty.h"
+#include "fsm.h"
+#include "memory.h"
+#include "modes.h"
+#include "reaction.h"
+#include "timeline.h"
+#include "timers.h"
+#include <unity.h>
+
+using namespace simon;
+
+//
+// Plays rounds through the real state machine with the modules the PLAYING states use,
+// the way Game does, and checks that the allocation accounting saw nothing in them.
+//
+
+#define TEST_ROUNDS 12
+
+#define TimerInputTimeout 0
+
+static GameMode* mode;
+static Sequence sequence;
+static Difficulty difficulty;
+static Timeline timeline;
+static TimelinePlayer player;
+static TimerWheel timers;
+static ReactionTimer reaction[MAX_PLAYERS];
+static LatencyStats latency[MAX_PLAYERS];
+static bool lose_round; // Answer the next round wrong
+
+static void onStateEnter(Fsm::StateType const& type) {
+    // Same rule as Game::onStateEnter
+    Memory::setState(type, type >= Fsm::StateType::PLAYING_SEQUENCE_STATE);
+}
+
+static void onStateExit(Fsm::StateType const& type) { timers.cancelState(type); }
+
+static void onTimerExpired(uint8_t id) {}
+
+static void playSequence() {
+    TEST_ASSERT_TRUE(mode->beginRound(sequence));
+    difficulty.update(sequence.size(), latency[mode->currentPlayer()]);
+    compileSequence(timeline,
+                    sequence,
+                    mode->playbackStart(sequence),
+                    difficulty.timing(),
+                    SEQUENCE_LEAD_IN_MS);
+    player.start(timeline, micros());
+
+    timeline_action_t action;
+    while (player.isPlaying()) {
+        native::advanceMs(TIMER_TICK_MS);
+        timers.poll(millis());
+        while (player.poll(micros(), action)) {
+        }
+    }
+}
+
+// Enters an input, right or wrong, and returns whether the mode accepted it
+static bool enterInput(uint8_t p, uint8_t index, bool right) {
+    native::advanceMs(300);
+    reaction[p].recordPress(micros());
+    native::advanceMs(120);
+    reaction[p].recordRelease(micros());
+    timers.poll(millis());
+
+    // Rejected colors leave the sequence alone, so try them in turn
+    for (uint8_t c = 0; c < COLORS_COUNT; c++) {
+        if (mode->checkInput(sequence, index, static_cast<color_t>(c)) == right) {
+            return right;
+        }
+    }
+    return !right;
+}
+
+static bool playInput() {
+    // Every player at once in concurrent modes, otherwise the one whose turn it is
+    uint8_t first  = mode->concurrent() ? 0 : mode->currentPlayer();
+    uint8_t last   = mode->concurrent() ? mode->players() - 1 : first;
+    uint8_t length = mode->inputLength(sequence); // Fixed for the round, like Game
+
+    for (uint8_t p = first; p <= last; p++) {
+        reaction[p].beginRound(micros());
+        timers.arm(TimerInputTimeout + p, IN_SEQUENCE_TIMEOUT, Fsm::PLAYING_USER_STATE);
+    }
+
+    for (uint8_t i = 0; i < length; i++) {
+        for (uint8_t p = first; p <= last; p++) {
+            if (!enterInput(p, i, !lose_round)) {
+                return false;
+            }
+        }
+    }
+
+    for (uint8_t p = first; p <= last; p++) {
+        reaction[p].commit(latency[p]);
+    }
+    return true;
+}
+
+static void playGame(uint8_t mode_index) {
+    mode = &gameMode(mode_index);
+
+    Fsm::reset();
+    Fsm::start();
+    TEST_ASSERT_TRUE(Fsm::dispatch(Fsm::GAME_START_EVENT));
+
+    sequence.clear();
+    mode->reset();
+    difficulty.reset();
+    for (LatencyStats& stats : latency) {
+        stats.reset();
+    }
+
+    for (uint8_t round = 0; round < TEST_ROUNDS; round++) {
+        lose_round = round == TEST_ROUNDS - 1;
+
+        TEST_ASSERT_TRUE(Fsm::dispatch(Fsm::PLAYING_SEQUENCE_EVENT));
+        playSequence();
+
+        TEST_ASSERT_TRUE(Fsm::dispatch(Fsm::PLAYING_USER_EVENT));
+        if (playInput()) {
+            TEST_ASSERT_TRUE(Fsm::dispatch(Fsm::PLAYING_WIN_EVENT));
+        } else {
+            TEST_ASSERT_TRUE(Fsm::dispatch(Fsm::PLAYING_LOSE_EVENT));
+        }
+    }
+    TEST_ASSERT_EQUAL(Fsm::PLAYING_LOSE_STATE, Fsm::currentState());
+    TEST_ASSERT_TRUE(Fsm::dispatch(Fsm::INITIAL_STATE_EVENT));
+}
+
+static void assertPlayingStatesAllocationFree() {
+    for (uint8_t state = Fsm::PLAYING_SEQUENCE_STATE; state < Fsm::STATE_TYPES_COUNT; state++) {
+        TEST_ASSERT_EQUAL(0, Memory::state(state).dynamic.allocations);
+        TEST_ASSERT_EQUAL(0, Memory::state(state).violations);
+    }
+    TEST_ASSERT_EQUAL(0, Memory::violations());
+}
+
+void setUp() {
+    Fsm::setEnterCallback(Fsm::CallbackEnterFunction::bind<&onStateEnter>());
+    Fsm::setExitCallback(Fsm::CallbackExitFunction::bind<&onStateExit>());
+    timers.setExpiredCallback(TimerWheel::CallbackFunction::bind<&onTimerExpired>());
+    timers.begin(millis());
+}
+
+void tearDown() {}
+
+void test_every_mode_plays_without_allocating() {
+    for (uint8_t m = 0; m < GAME_MODES_COUNT; m++) {
+        playGame(m);
+    }
+    assertPlayingStatesAllocationFree();
+}
+
+void test_allocation_in_playing_state_is_reported() {
+    // The counters above are only worth something if an allocation does show up
+    const Memory::state_usage_t& usage = Memory::state(Fsm::PLAYING_USER_STATE);
+    uint32_t allocations               = usage.dynamic.allocations;
+    uint32_t violations                = Memory::violations();
+
+    Memory::setState(Fsm::PLAYING_USER_STATE, true);
+    int* value = new int(1);
+    delete value;
+    Memory::setState(Fsm::INITIAL_STATE, false);
+
+    TEST_ASSERT_EQUAL(allocations + 1, usage.dynamic.allocations);
+    TEST_ASSERT_EQUAL(violations + 1, Memory::violations());
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_every_mode_plays_without_allocating);
+    RUN_TEST(test_allocation_in_playing_state_is_reported);
+    return UNITY_END();
+}
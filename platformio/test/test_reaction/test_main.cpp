@@ -0,0 +1,108 @@
+#include "reaction.h"
+#include <unity.h>
+
+using namespace simon;
+
+// Reported value of the bucket holding the given latency
+static uint32_t bucketMs(uint32_t latency_ms) {
+    return (latency_ms / REACTION_BUCKET_MS) * REACTION_BUCKET_MS + REACTION_BUCKET_MS / 2;
+}
+
+void setUp() {}
+
+void tearDown() {}
+
+void test_empty_stats_report_zero() {
+    LatencyStats stats;
+
+    TEST_ASSERT_EQUAL(0, stats.count());
+    TEST_ASSERT_EQUAL(0, stats.minMs());
+    TEST_ASSERT_EQUAL(0, stats.medianMs());
+    TEST_ASSERT_EQUAL(0, stats.p95Ms());
+}
+
+void test_single_sample() {
+    LatencyStats stats;
+    stats.add(253000);
+
+    TEST_ASSERT_EQUAL(1, stats.count());
+    TEST_ASSERT_EQUAL(253, stats.minMs()); // Exact
+    TEST_ASSERT_EQUAL(bucketMs(253), stats.medianMs());
+    TEST_ASSERT_EQUAL(bucketMs(253), stats.p95Ms());
+}
+
+void test_overflow_bucket() {
+    // Slower than the histogram range: counted in the last bucket, min stays exact
+    LatencyStats stats;
+    stats.add(IN_SEQUENCE_TIMEOUT * 3000UL);
+
+    TEST_ASSERT_EQUAL(IN_SEQUENCE_TIMEOUT * 3, stats.minMs());
+    TEST_ASSERT_EQUAL((REACTION_BUCKETS - 1) * REACTION_BUCKET_MS + REACTION_BUCKET_MS / 2,
+                      stats.p95Ms());
+}
+
+void test_percentile_rank_rounds_up() {
+    // 19 fast inputs and a slow one: rank 19 of 20 for p95, the slow one only at p100
+    LatencyStats stats;
+    for (uint8_t i = 0; i < 19; i++) {
+        stats.add(100000);
+    }
+    stats.add(1000000);
+
+    TEST_ASSERT_EQUAL(bucketMs(100), stats.medianMs());
+    TEST_ASSERT_EQUAL(bucketMs(100), stats.p95Ms());
+
+    stats.add(1000000); // Rank 20 of 21 is now a slow one
+    TEST_ASSERT_EQUAL(bucketMs(1000), stats.p95Ms());
+}
+
+void test_reset_forgets_samples() {
+    LatencyStats stats;
+    stats.add(100000);
+    stats.reset();
+
+    TEST_ASSERT_EQUAL(0, stats.count());
+    TEST_ASSERT_EQUAL(0, stats.minMs());
+    TEST_ASSERT_EQUAL(0, stats.p95Ms());
+}
+
+void test_latency_from_previous_release() {
+    ReactionTimer timer;
+    timer.beginRound(1000000);
+    timer.recordPress(1300000);
+    timer.recordRelease(1400000);
+    timer.recordPress(1650000);
+
+    TEST_ASSERT_EQUAL(300000, timer.latencyUs(0)); // From the start of the round
+    TEST_ASSERT_EQUAL(250000, timer.latencyUs(1)); // From the previous release
+}
+
+void test_latency_after_missed_release() {
+    ReactionTimer timer;
+    timer.beginRound(1000000);
+    timer.recordPress(1300000);
+    timer.recordPress(1500000); // The release of the first press was never seen
+
+    TEST_ASSERT_EQUAL(200000, timer.latencyUs(1)); // From the previous press
+}
+
+void test_latency_across_micros_wrap() {
+    ReactionTimer timer;
+    timer.beginRound(UINT32_MAX - 99999);
+    timer.recordPress(200000);
+
+    TEST_ASSERT_EQUAL(300000, timer.latencyUs(0));
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_empty_stats_report_zero);
+    RUN_TEST(test_single_sample);
+    RUN_TEST(test_overflow_bucket);
+    RUN_TEST(test_percentile_rank_rounds_up);
+    RUN_TEST(test_reset_forgets_samples);
+    RUN_TEST(test_latency_from_previous_release);
+    RUN_TEST(test_latency_after_missed_release);
+    RUN_TEST(test_latency_across_micros_wrap);
+    return UNITY_END();
+}
@@ -0,0 +1,184 @@
+// Built with the test rather than from src: the test corrupts the record on purpose
+#include "../../src/snapshot.cpp"
+#include <unity.h>
+
+using namespace simon;
+
+static game_snapshot_t game;
+static Sequence sequence;
+
+static void fillSequence(uint8_t length) {
+    sequence.clear();
+    for (uint8_t i = 0; i < length; i++) {
+        sequence.push(static_cast<color_t>((i * 7 + i / 3) % COLORS_COUNT));
+    }
+}
+
+void setUp() {
+    Snapshot::discard();
+    native::reset_reason = ESP_RST_SW;
+    game                 = {};
+}
+
+void tearDown() {}
+
+void test_nothing_recorded() {
+    game_snapshot_t restored;
+    Sequence restored_sequence;
+    TEST_ASSERT_FALSE(Snapshot::restore(restored, restored_sequence));
+}
+
+void test_round_trip() {
+    game.mode       = 4;
+    game.mode_state = 3;
+    game.out        = 0x02;
+    game.scores[1]  = 12;
+    fillSequence(MAX_SEQUENCE_LENGTH - 1); // Last byte partly used
+    Snapshot::save(game, sequence);
+
+    game_snapshot_t restored;
+    Sequence restored_sequence;
+    TEST_ASSERT_TRUE(Snapshot::restore(restored, restored_sequence));
+    TEST_ASSERT_EQUAL(4, restored.mode);
+    TEST_ASSERT_EQUAL(3, restored.mode_state);
+    TEST_ASSERT_EQUAL(0x02, restored.out);
+    TEST_ASSERT_EQUAL(12, restored.scores[1]);
+    TEST_ASSERT_EQUAL(sequence.size(), restored_sequence.size());
+    for (uint8_t i = 0; i < sequence.size(); i++) {
+        TEST_ASSERT_EQUAL(sequence[i], restored_sequence[i]);
+    }
+}
+
+void test_shorter_sequence_after_longer_one() {
+    // Bytes past the new length are stale and not covered by the CRC
+    fillSequence(40);
+    Snapshot::save(game, sequence);
+    fillSequence(5);
+    Snapshot::save(game, sequence);
+
+    Sequence restored_sequence;
+    TEST_ASSERT_TRUE(Snapshot::restore(game, restored_sequence));
+    TEST_ASSERT_EQUAL(5, restored_sequence.size());
+}
+
+void test_round_appends_one_color() {
+    // One round after the other, only the new color is written
+    fillSequence(1);
+    Snapshot::save(game, sequence);
+    for (uint8_t length = 2; length <= 13; length++) {
+        color_t next = static_cast<color_t>((length * 5) % COLORS_COUNT);
+        sequence.push(next);
+        Snapshot::save(game, sequence, length - 1);
+    }
+
+    Sequence restored_sequence;
+    TEST_ASSERT_TRUE(Snapshot::restore(game, restored_sequence));
+    TEST_ASSERT_EQUAL(13, restored_sequence.size());
+    for (uint8_t i = 0; i < sequence.size(); i++) {
+        TEST_ASSERT_EQUAL(sequence[i], restored_sequence[i]);
+    }
+}
+
+void test_corrupted_color_rejected() {
+    fillSequence(10);
+    Snapshot::save(game, sequence);
+    Snapshot::record.colors[1] ^= 0x04;
+
+    Sequence restored_sequence;
+    TEST_ASSERT_FALSE(Snapshot::restore(game, restored_sequence));
+}
+
+void test_corrupted_header_rejected() {
+    fillSequence(10);
+    Snapshot::save(game, sequence);
+    Snapshot::record.game.scores[0] ^= 0x80;
+
+    Sequence restored_sequence;
+    TEST_ASSERT_FALSE(Snapshot::restore(game, restored_sequence));
+}
+
+void test_invalid_length_rejected() {
+    // A CRC match alone does not make the record plausible
+    fillSequence(10);
+    Snapshot::save(game, sequence);
+    Snapshot::record.length = MAX_SEQUENCE_LENGTH + 1;
+    Snapshot::record.crc    = Snapshot::recordCrc();
+
+    Sequence restored_sequence;
+    TEST_ASSERT_FALSE(Snapshot::restore(game, restored_sequence));
+}
+
+void test_power_on_record_rejected() {
+    // RTC memory content after a power cycle is not trusted, even with a valid CRC
+    fillSequence(10);
+    Snapshot::save(game, sequence);
+    native::reset_reason = ESP_RST_POWERON;
+
+    Sequence restored_sequence;
+    TEST_ASSERT_FALSE(Snapshot::restore(game, restored_sequence));
+}
+
+void test_brownout_record_restored() {
+    fillSequence(10);
+    Snapshot::save(game, sequence);
+    native::reset_reason = ESP_RST_BROWNOUT;
+
+    Sequence restored_sequence;
+    TEST_ASSERT_TRUE(Snapshot::restore(game, restored_sequence));
+    TEST_ASSERT_EQUAL(10, restored_sequence.size());
+}
+
+void test_round_resumed_once() {
+    fillSequence(10);
+    Snapshot::save(game, sequence);
+    native::reset_reason = ESP_RST_TASK_WDT;
+
+    Sequence restored_sequence;
+    TEST_ASSERT_TRUE(Snapshot::restore(game, restored_sequence));
+
+    // The resumed round is saved again, then the board resets before the next one
+    Snapshot::save(game, restored_sequence);
+    TEST_ASSERT_FALSE(Snapshot::restore(game, restored_sequence));
+
+    // Dropped for good
+    TEST_ASSERT_FALSE(Snapshot::restore(game, restored_sequence));
+}
+
+void test_next_round_allows_a_new_resume() {
+    fillSequence(10);
+    Snapshot::save(game, sequence);
+
+    Sequence restored_sequence;
+    TEST_ASSERT_TRUE(Snapshot::restore(game, restored_sequence));
+
+    fillSequence(11); // The resumed round was won
+    Snapshot::save(game, sequence);
+    TEST_ASSERT_TRUE(Snapshot::restore(game, restored_sequence));
+    TEST_ASSERT_EQUAL(11, restored_sequence.size());
+}
+
+void test_discarded_record_rejected() {
+    fillSequence(10);
+    Snapshot::save(game, sequence);
+    Snapshot::discard();
+
+    Sequence restored_sequence;
+    TEST_ASSERT_FALSE(Snapshot::restore(game, restored_sequence));
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_nothing_recorded);
+    RUN_TEST(test_round_trip);
+    RUN_TEST(test_shorter_sequence_after_longer_one);
+    RUN_TEST(test_round_appends_one_color);
+    RUN_TEST(test_corrupted_color_rejected);
+    RUN_TEST(test_corrupted_header_rejected);
+    RUN_TEST(test_invalid_length_rejected);
+    RUN_TEST(test_power_on_record_rejected);
+    RUN_TEST(test_brownout_record_restored);
+    RUN_TEST(test_round_resumed_once);
+    RUN_TEST(test_next_round_allows_a_new_resume);
+    RUN_TEST(test_discarded_record_rejected);
+    return UNITY_END();
+}
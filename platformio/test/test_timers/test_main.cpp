@@ -0,0 +1,127 @@
+#include "timers.h"
+#include <unity.h>
+
+using namespace simon;
+
+static TimerWheel wheel;
+static uint8_t expired[16]; // Ids in the order they were reported
+static uint8_t expired_count;
+static int8_t cancel_on_expiry; // Timer cancelled by the callback, or TIMER_NONE
+
+static void onExpired(uint8_t id) {
+    if (expired_count < sizeof(expired)) {
+        expired[expired_count] = id;
+    }
+    expired_count++;
+
+    if (cancel_on_expiry != TIMER_NONE) {
+        wheel.cancel(cancel_on_expiry);
+    }
+}
+
+void setUp() {
+    wheel = TimerWheel();
+    wheel.setExpiredCallback(TimerWheel::CallbackFunction::bind<&onExpired>());
+    expired_count    = 0;
+    cancel_on_expiry = TIMER_NONE;
+}
+
+void tearDown() {}
+
+void test_one_shot_never_expires_early() {
+    wheel.begin(0);
+    wheel.arm(1, 25); // Rounded up to 3 ticks
+
+    wheel.poll(29);
+    TEST_ASSERT_EQUAL(0, expired_count);
+
+    wheel.poll(30);
+    TEST_ASSERT_EQUAL(1, expired_count);
+    TEST_ASSERT_EQUAL(1, expired[0]);
+    TEST_ASSERT_FALSE(wheel.isArmed(1));
+
+    wheel.poll(1000);
+    TEST_ASSERT_EQUAL(1, expired_count);
+}
+
+void test_expiry_across_millis_wrap() {
+    const uint32_t start = UINT32_MAX - 15;
+    wheel.begin(start);
+    wheel.arm(2, 50);
+
+    wheel.poll(start + 40);
+    TEST_ASSERT_EQUAL(0, expired_count);
+
+    wheel.poll(start + 50); // millis() rolled over to 34
+    TEST_ASSERT_EQUAL(1, expired_count);
+    TEST_ASSERT_EQUAL(2, expired[0]);
+}
+
+void test_timer_longer_than_a_revolution() {
+    const uint32_t revolution_ms = TIMER_WHEEL_SLOTS * TIMER_TICK_MS;
+    wheel.begin(0);
+    wheel.arm(3, revolution_ms + 360);
+
+    wheel.poll(360); // First pass over the slot
+    TEST_ASSERT_EQUAL(0, expired_count);
+
+    wheel.poll(revolution_ms + 350);
+    TEST_ASSERT_EQUAL(0, expired_count);
+
+    wheel.poll(revolution_ms + 360);
+    TEST_ASSERT_EQUAL(1, expired_count);
+}
+
+void test_periodic_timer_rearms() {
+    wheel.begin(0);
+    wheel.arm(0, 100, TIMER_STATE, 100);
+
+    wheel.poll(350);
+    TEST_ASSERT_EQUAL(3, expired_count);
+    TEST_ASSERT_TRUE(wheel.isArmed(0));
+}
+
+void test_cancel_before_expiry() {
+    wheel.begin(0);
+    wheel.arm(4, 50);
+    wheel.cancel(4);
+
+    wheel.poll(100);
+    TEST_ASSERT_EQUAL(0, expired_count);
+    TEST_ASSERT_FALSE(wheel.isArmed(4));
+}
+
+void test_cancel_from_callback_in_same_slot() {
+    // Both timers expire on the same tick: the first one reported cancels the other
+    wheel.begin(0);
+    wheel.arm(5, 50);
+    wheel.arm(6, 50);
+    cancel_on_expiry = 5;
+
+    wheel.poll(50);
+    TEST_ASSERT_EQUAL(1, expired_count);
+    TEST_ASSERT_EQUAL(6, expired[0]);
+}
+
+void test_cancel_state_keeps_other_states() {
+    wheel.begin(0);
+    wheel.arm(1, 50, 2);
+    wheel.arm(2, 50, 3);
+    wheel.cancelState(2);
+
+    wheel.poll(50);
+    TEST_ASSERT_EQUAL(1, expired_count);
+    TEST_ASSERT_EQUAL(2, expired[0]);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_one_shot_never_expires_early);
+    RUN_TEST(test_expiry_across_millis_wrap);
+    RUN_TEST(test_timer_longer_than_a_revolution);
+    RUN_TEST(test_periodic_timer_rearms);
+    RUN_TEST(test_cancel_before_expiry);
+    RUN_TEST(test_cancel_from_callback_in_same_slot);
+    RUN_TEST(test_cancel_state_keeps_other_states);
+    return UNITY_END();
+}